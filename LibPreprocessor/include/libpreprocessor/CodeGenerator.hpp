@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Compiler.hpp"
+
+#include <liberror/Result.hpp>
+
+#include <string>
+
+namespace libpreprocessor {
+
+struct CodeGeneratorOptions
+{
+    std::string functionName { "render" };
+    // left empty, the function is declared in the global namespace.
+    std::string namespaceName {};
+    // mentioned in the header of the generated file.
+    std::string source {};
+};
+
+// turns a compiled template into a C++ header defining two inline functions named after `functionName`:
+//
+//     liberror::Result<void> render(libpreprocessor::PreprocessorContext const& context, std::string& output);
+//     liberror::Result<std::string> render(libpreprocessor::PreprocessorContext const& context);
+//
+// which render it as straight-line code, with every statement and comparison spelled out and the content between
+// them appended in a single call. their output, what they print and the errors they fail with match `interpret`.
+liberror::Result<std::string> generate_cpp(Template const& compiled, CodeGeneratorOptions const& options = {});
+
+} // namespace libpreprocessor
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "nodes/INode.hpp"
+
+#include <liberror/Result.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace libpreprocessor {
+
+class SymbolTable
+{
+public:
+    size_t intern(std::string_view name);
+    std::optional<size_t> find(std::string_view name) const;
+
+    std::string const& name_of(size_t slot) const { return _names.at(slot); }
+    std::vector<std::string> const& names() const noexcept { return _names; }
+    size_t size() const noexcept { return _names.size(); }
+
+private:
+    // lets `find` look names up by `std::string_view` without building a `std::string` for every lookup.
+    struct NameHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const noexcept { return std::hash<std::string_view> {}(name); }
+    };
+
+    std::vector<std::string> _names {};
+    std::unordered_map<std::string, size_t, NameHash, std::equal_to<>> _slots {};
+};
+
+// the size of the output last rendered from a template. it's only a hint for how much to reserve, so renders on
+// different threads are free to overwrite each other's.
+class OutputSizeHint
+{
+public:
+    OutputSizeHint() = default;
+    OutputSizeHint(OutputSizeHint const& other) noexcept : _size { other.load() } {}
+
+    OutputSizeHint& operator=(OutputSizeHint const& other) noexcept
+    {
+        store(other.load());
+        return *this;
+    }
+
+    size_t load() const noexcept { return _size.load(std::memory_order_relaxed); }
+    void store(size_t size) const noexcept { _size.store(size, std::memory_order_relaxed); }
+
+private:
+    mutable std::atomic<size_t> _size {};
+};
+
+struct Template
+{
+    std::unique_ptr<INode> head {};
+    // every variable the template reads, a render depends on nothing else from the context.
+    SymbolTable symbols {};
+    // unique to every compiled template, so caches can tell them apart.
+    uint64_t id {};
+    // whether the template holds %PRINT statements, which a cached output doesn't replay.
+    bool prints {};
+    // the size of every content in the template, which no output can exceed since content is all a render writes.
+    size_t contentBytes {};
+    OutputSizeHint lastOutputSize {};
+};
+
+// filled by the overloads taking it, `compile` fills in everything up to and including `compiling` and `interpret` the rest.
+struct Statistics
+{
+    std::chrono::nanoseconds lexing {};
+    std::chrono::nanoseconds parsing {};
+    std::chrono::nanoseconds compiling {};
+    std::chrono::nanoseconds interpreting {};
+
+    size_t tokens {};
+    // indexed by `INode::Type`.
+    std::array<size_t, static_cast<size_t>(INode::Type::END__)> nodes {};
+
+    size_t outputBytes {};
+    // the most the render's buffers held at once, output and provided values included.
+    size_t peakScratchBytes {};
+    // every read of a variable's value, so only in the branches the render took and once per read.
+    size_t variableLookups {};
+};
+
+liberror::Result<void> compile(std::unique_ptr<INode> const& head, SymbolTable& symbols);
+// compiles an already parsed tree, as `load_image` rebuilds it.
+liberror::Result<Template> compile(std::unique_ptr<INode> head);
+liberror::Result<Template> compile(std::string_view source);
+liberror::Result<Template> compile(std::filesystem::path path);
+// compiles `source`, which the caller read from `path` already.
+liberror::Result<Template> compile(std::filesystem::path path, std::string_view source);
+liberror::Result<Template> compile(std::string_view source, Statistics& statistics);
+liberror::Result<Template> compile(std::filesystem::path path, Statistics& statistics);
+
+} // namespace libpreprocessor
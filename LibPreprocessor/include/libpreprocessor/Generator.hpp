@@ -0,0 +1,110 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace libpreprocessor {
+
+// a lazily evaluated input range of the values a coroutine yields, standing in for `std::generator` which
+// the standard libraries we build against don't ship yet. the coroutine only runs while the range is being
+// iterated, and destroying the generator stops it wherever it was suspended.
+template <typename T>
+class Generator
+{
+public:
+    struct promise_type
+    {
+        Generator get_return_object() noexcept { return Generator { std::coroutine_handle<promise_type>::from_promise(*this) }; }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_always final_suspend() const noexcept { return {}; }
+
+        // the yielded value lives in the coroutine until it's resumed, so only its address is kept.
+        std::suspend_always yield_value(T const& value) noexcept
+        {
+            current = std::addressof(value);
+            return {};
+        }
+
+        void return_void() const noexcept {}
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+        template <typename U>
+        std::suspend_never await_transform(U&&) = delete;
+
+        T const* current {};
+        std::exception_ptr exception {};
+    };
+
+    class iterator
+    {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(std::coroutine_handle<promise_type> handle) noexcept : _handle { handle } {}
+
+        T const& operator*() const noexcept { return *_handle.promise().current; }
+        T const* operator->() const noexcept { return _handle.promise().current; }
+
+        iterator& operator++()
+        {
+            resume(_handle);
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const noexcept { return _handle == nullptr || _handle.done(); }
+
+    private:
+        std::coroutine_handle<promise_type> _handle {};
+    };
+
+    Generator(Generator&& other) noexcept : _handle { std::exchange(other._handle, {}) } {}
+
+    Generator& operator=(Generator&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (_handle) _handle.destroy();
+            _handle = std::exchange(other._handle, {});
+        }
+
+        return *this;
+    }
+
+    Generator(Generator const&) = delete;
+    Generator& operator=(Generator const&) = delete;
+
+    ~Generator()
+    {
+        if (_handle) _handle.destroy();
+    }
+
+    // runs the coroutine up to its first value, so it may only be called once.
+    iterator begin()
+    {
+        resume(_handle);
+        return iterator { _handle };
+    }
+
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+    explicit Generator(std::coroutine_handle<promise_type> handle) noexcept : _handle { handle } {}
+
+    static void resume(std::coroutine_handle<promise_type> handle)
+    {
+        handle.resume();
+        if (auto const exception = std::exchange(handle.promise().exception, {})) std::rethrow_exception(exception);
+    }
+
+    std::coroutine_handle<promise_type> _handle {};
+};
+
+} // namespace libpreprocessor
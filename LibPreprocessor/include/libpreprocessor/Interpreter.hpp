@@ -1,19 +1,198 @@
 #pragma once
 
+#include "Compiler.hpp"
+#include "Generator.hpp"
+#include "Profiler.hpp"
+#include "VariableMap.hpp"
 #include "nodes/INode.hpp"
 
 #include <liberror/Result.hpp>
 
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
 namespace libpreprocessor {
 
+// where the lines of %PRINT statements go.
+struct PrintSink
+{
+    enum class Type
+    {
+        BEGIN__,
+        // written to stdout in a single call once the render is over, rather than each as it's printed, so concurrent
+        // renders never interleave their lines. a long render only shows its lines once it's done, failed ones
+        // included.
+        STDOUT,
+        // %PRINT statements aren't even evaluated.
+        DISCARD,
+        // kept in `RenderScratch::printed`, next to the output they were printed while rendering. only `interpret`
+        // into a scratch has somewhere to return them, every other render fails with this sink instead of losing them.
+        BUFFER,
+        // handed to `callback` as soon as they're printed, concurrently when rendering on several threads.
+        CALLBACK,
+        END__
+    };
+
+    Type type { Type::STDOUT };
+    std::function<void(std::string_view line)> callback {};
+};
+
+// answers for a variable a context doesn't hold, or `std::nullopt` when there's no such variable either.
+using VariableProvider = std::function<std::optional<std::string>(std::string_view name)>;
+// what a provider answered during a render, by the name of the variable it was asked about.
+using ProvidedValues = std::map<std::string, std::optional<std::string>, std::less<>>;
+
 struct PreprocessorContext
 {
-    std::unordered_map<std::string, std::string> environmentVariables {};
+    // the value of a variable, looking through `environmentVariables` before `baseVariables`.
+    VariableValue const* find_variable(std::string_view name) const noexcept
+    {
+        if (auto const variable = environmentVariables.find(name); variable != environmentVariables.end()) return &variable->second;
+        if (baseVariables == nullptr) return nullptr;
+        if (auto const variable = baseVariables->find(name); variable != baseVariables->end()) return &variable->second;
+        return nullptr;
+    }
+
+    VariableMap environmentVariables {};
+    PrintSink print {};
+    // shared by every context that only overrides a few of its variables, so building one costs as much as the
+    // overrides do. it's never modified through a context, which makes it safe to share between threads.
+    std::shared_ptr<VariableMap const> baseVariables {};
+    // asked about variables neither of the above hold, only once a render reads them and at most once per render,
+    // so expensive ones are only computed by the templates that need them. renders on several threads may ask it
+    // concurrently.
+    VariableProvider provider {};
+};
+
+// the buffers a render works in. a scratch belongs to one thread at a time, and keeping it around between renders
+// means rendering stops allocating once its buffers have grown large enough.
+struct RenderScratch
+{
+    std::string output {};
+    std::vector<std::string_view> values {};
+    ProvidedValues provided {};
+    std::vector<std::string> printed {};
 };
 
+// rendering never modifies a compiled template nor the context, so any number of threads can render the same
+// template concurrently. see `PrintSink` for where %PRINT output goes.
 liberror::Result<std::string> interpret(std::unique_ptr<INode> const& head, PreprocessorContext const& context);
+liberror::Result<std::string> interpret(Template const& compiled, PreprocessorContext const& context);
+// the returned view points into `scratch.output`, and stays valid until the scratch is rendered into again. lines
+// printed to the BUFFER sink are kept in `scratch.printed`.
+liberror::Result<std::string_view> interpret(Template const& compiled, PreprocessorContext const& context, RenderScratch& scratch);
+// measures every node reached while rendering into `profiler`, adding up with what it already measured.
+liberror::Result<std::string> interpret(Template const& compiled, PreprocessorContext const& context, Profiler& profiler);
+// fills in `interpreting` and everything after it in `statistics`, as counted while rendering.
+liberror::Result<std::string> interpret(Template const& compiled, PreprocessorContext const& context, Statistics& statistics);
+
+// renders lazily, yielding the output piece by piece as it's pulled. a piece stays valid until the next one is
+// pulled, an error is the last piece, and destroying the generator stops the render wherever it got to.
+// both the template and the context have to outlive the generator.
+Generator<liberror::Result<std::string_view>> interpret_chunks(Template const& compiled, PreprocessorContext const& context);
+
+struct BatchOptions
+{
+    // how many threads render the batch, 0 means one per hardware thread.
+    size_t threads { 1 };
+};
+
+// receives the output of every item as soon as it's rendered. the view is only valid during the call, and when
+// rendering with more than one thread the sink is called concurrently (never twice for the same index).
+using BatchSink = std::function<void(size_t index, liberror::Result<std::string_view> const& output)>;
+
+void interpret_batch(Template const& compiled, std::span<PreprocessorContext const> contexts, BatchSink const& sink, BatchOptions const& options = {});
+std::vector<liberror::Result<std::string>> interpret_batch(Template const& compiled, std::span<PreprocessorContext const> contexts, BatchOptions const& options = {});
+
+// renders a template once, then re-renders only the top-level blocks which read a variable when it's updated,
+// splicing their new output into the previous one. the template has to outlive the session.
+class RenderSession
+{
+public:
+    RenderSession(Template const& compiled, PreprocessorContext context);
+
+    // renders every block from scratch.
+    liberror::Result<std::string_view> render();
+    // before the first render, or after a failed one, every block is rendered.
+    liberror::Result<std::string_view> update(std::string_view name, std::string value);
+
+    std::string_view output() const noexcept { return _output; }
+    PreprocessorContext const& context() const noexcept { return _context; }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<INode> const* node {};
+        size_t offset {};
+        size_t size {};
+        // the slots whose values were read the last time the block was rendered, through the branches it took.
+        std::vector<bool> reads {};
+    };
+
+    liberror::Result<void> render_block(size_t index);
+
+    Template const* _compiled {};
+    PreprocessorContext _context {};
+    std::vector<std::string_view> _values {};
+    // kept until the next full render, so updates don't ask the provider again.
+    ProvidedValues _provided {};
+    std::vector<Block> _blocks {};
+    std::string _output {};
+    bool _rendered {};
+};
+
+// what code produced by `generate_cpp` renders through, so it reads variables and prints the same way `interpret`
+// does. lines printed to stdout are written once the render is over, when it's destroyed.
+class GeneratedRender
+{
+public:
+    // `names` holds the name of the variable in every slot, and has to outlive the render.
+    GeneratedRender(PreprocessorContext const& context, std::span<std::string_view const> names);
+    ~GeneratedRender();
+
+    GeneratedRender(GeneratedRender const&) = delete;
+    GeneratedRender& operator=(GeneratedRender const&) = delete;
+
+    // bound on the first read, asking the context's provider if it has to.
+    std::string_view value(size_t slot);
+
+    // whether %PRINT statements are evaluated at all.
+    bool prints() const noexcept { return _context.print.type != PrintSink::Type::DISCARD; }
+    liberror::Result<void> print(std::string line);
+    // a generated render has nowhere to return buffered lines, so it fails with the BUFFER sink like `interpret` does.
+    static liberror::Result<void> check_sink(PrintSink const& sink);
+
+    static std::string join(std::initializer_list<std::string_view> pieces);
+    // reading an empty literal fails the same way interpreting one does.
+    static liberror::Result<std::string_view> empty_literal();
+
+private:
+    PreprocessorContext const& _context;
+    std::span<std::string_view const> _names {};
+    std::vector<std::string_view> _values {};
+    ProvidedValues _provided {};
+    std::vector<std::string> _printed {};
+};
+
+namespace internal {
+
+// fails with the BUFFER sink, for the renders that have nowhere to return the lines it keeps.
+liberror::Result<void> require_unbuffered(PrintSink const& sink);
+// a literal decays to an integer when it starts with one, optionally after whitespace and a sign.
+liberror::Result<size_t> decay_to_integer(std::string_view literal);
+// TRUE, FALSE, or an integer which is true when it isn't zero.
+liberror::Result<bool> decay_to_boolean(std::string_view literal);
+// like `interpret` into a scratch, but answers from what `scratch.provided` already holds instead of clearing it,
+// so variables asked about before the render aren't asked about again.
+liberror::Result<std::string_view> interpret_seeded(Template const& compiled, PreprocessorContext const& context, RenderScratch& scratch);
+
+} // namespace internal
 
 } // namespace libpreprocessor
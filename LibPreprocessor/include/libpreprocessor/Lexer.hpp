@@ -6,8 +6,11 @@
 #include <liberror/Result.hpp>
 #include <liberror/Try.hpp>
 
-#include <optional>
+#include <algorithm>
 #include <array>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace libpreprocessor {
 
@@ -21,58 +24,113 @@ static constexpr std::array operator_g {
     std::pair { "NOT", OperatorNode::Arity::UNARY  },
 };
 
-class Lexer
-{
-public:
-    explicit Lexer(std::string_view source);
-    explicit Lexer(std::filesystem::path file);
+// where the tokens of a template that isn't read from a file are located.
+static constexpr std::string_view unknown_file_location_g = "Local/Global Variable";
 
-    // FIXME: should find a way to make this an erroable function.
-    std::vector<Token> tokenize();
+// a token as the lexer reads it, pointing into the source it was read from.
+struct TokenView
+{
+    Token::Type type {};
+    std::string_view data {};
+    // the same as `Token::Location::position`.
+    std::pair<size_t, size_t> position {};
+};
 
-private:
+// the rules `Lexer` reads templates by. they only look at the source, so templates can be read by the very same
+// rules while the program is compiled. spaces ending a line are dropped, and an empty line is read as a line break.
+constexpr std::vector<TokenView> scan(std::string_view source)
+{
+    constexpr std::string_view specials { special_g.data(), special_g.size() };
 
-    friend size_t skip_spaces(Lexer&);
+    std::vector<TokenView> tokens {};
 
-    bool eof() const
+    for (auto begin = 0zu, line = 1zu; begin < source.size(); line += 1)
     {
-        return cursor.second >= source.at(cursor.first).size();
+        auto const end = std::min(source.find('\n', begin), source.size());
+        auto const text = end == begin ? std::string_view { "\n" } : source.substr(begin, end - begin);
+        begin = end + 1;
+
+        for (auto cursor = 0zu; cursor < text.size();)
+        {
+            auto const skipped = std::min(text.find_first_not_of(' ', cursor), text.size()) - cursor;
+            if (cursor + skipped == text.size()) break;
+            cursor += skipped;
+
+            // what follows the cursor up to the first of `stops`, or up to the end of the line.
+            auto const fnRun = [text, cursor] (std::string_view stops) {
+                return text.substr(cursor, std::min(text.find_first_of(stops, cursor), text.size()) - cursor);
+            };
+
+            TokenView token {};
+
+            if (specials.contains(text[cursor]))
+            {
+                token.data = text.substr(cursor, 1);
+
+                switch (text[cursor])
+                {
+                case '%': token.type = Token::Type::PERCENT; break;
+                case '[': token.type = Token::Type::LEFT_SQUARE_BRACKET; break;
+                case '<': token.type = Token::Type::LEFT_ANGLE_BRACKET; break;
+                case '>': token.type = Token::Type::RIGHT_ANGLE_BRACKET; break;
+                case ']': token.type = Token::Type::RIGHT_SQUARE_BRACKET; break;
+                case ':': token.type = Token::Type::COLON; break;
+                default: break;
+                }
+            }
+            else if (auto const keyword = fnRun(specials); std::ranges::find(keyword_g, keyword) != keyword_g.end())
+            {
+                token = { Token::Type::KEYWORD, keyword };
+            }
+            else if (auto const name = fnRun(" "); std::ranges::find(operator_g, name, &decltype(operator_g)::value_type::first) != operator_g.end())
+            {
+                token = { Token::Type::OPERATOR, name };
+            }
+            else if (!tokens.empty() && tokens.back().type == Token::Type::LEFT_ANGLE_BRACKET)
+            {
+                // a variable names its kind and itself, so it splits in two parts on colons, a trailing one aside.
+                auto const literal = fnRun(">]");
+                auto const parts = static_cast<size_t>(std::ranges::count(literal, ':')) + 1 - (literal.ends_with(':') ? 1 : 0);
+                auto const identifier = parts == 2;
+
+                token = { identifier ? Token::Type::IDENTIFIER : Token::Type::LITERAL, literal };
+            }
+            else
+            {
+                // content takes the rest of the line, along with the spaces skipped before it.
+                cursor -= skipped;
+                token = { Token::Type::CONTENT, text.substr(cursor) };
+
+                // FIXME: find a better way to handle this
+                if (auto const justifyCount = static_cast<size_t>(std::ranges::count(token.data, '@')))
+                    token.data.remove_prefix(std::min(justifyCount * 4 + justifyCount + 1, token.data.size()));
+
+                cursor = text.size() - token.data.size();
+            }
+
+            cursor += token.data.size();
+            token.position = { line, cursor + token.data.size() - 1 };
+            tokens.push_back(token);
+        }
     }
 
-    liberror::Result<char> peek() const
-    {
-        if (eof())
-            return liberror::make_error("End of file reached");
-        return source.at(cursor.first).at(cursor.second);
-    }
+    return tokens;
+}
 
-    liberror::Result<char> take()
-    {
-        if (eof())
-            return liberror::make_error("End of file reached");
-        return source.at(cursor.first).at(cursor.second++);
-    }
+class Lexer
+{
+public:
+    explicit Lexer(std::string_view source);
+    explicit Lexer(std::filesystem::path file);
+    // for a file its caller already read, whose path tokens are still located by.
+    Lexer(std::filesystem::path file, std::string_view source);
 
-    std::optional<Token> next_special();
-    std::optional<Token> next_keyword();
-    std::optional<Token> next_operator();
-    std::optional<Token> next_literal();
-    std::optional<Token> next_identifier();
-    std::optional<Token> next_content();
+    std::vector<Token> tokenize() const;
 
+private:
     std::filesystem::path file;
-    std::vector<std::string> source;
-    std::pair<size_t, size_t> cursor;
-    std::vector<Token> tokens;
+    std::string source;
 };
 
-inline size_t skip_spaces(Lexer& lexer)
-{
-    size_t count = 0;
-    for (; MUST(lexer.peek()) == ' '; count += 1)
-        MUST(lexer.take());
-    return count;
-}
-
 } // namespace libpreprocessor
 
@@ -11,6 +11,10 @@ namespace libpreprocessor {
 
 liberror::Result<std::string> process(std::string_view source, PreprocessorContext const& context);
 liberror::Result<std::string> process(std::filesystem::path path, PreprocessorContext const& context);
+liberror::Result<std::string> process(std::string_view source, PreprocessorContext const& context, Statistics& statistics);
+liberror::Result<std::string> process(std::filesystem::path path, PreprocessorContext const& context, Statistics& statistics);
+
+liberror::Result<std::vector<liberror::Result<std::string>>> process_batch(std::string_view source, std::span<PreprocessorContext const> contexts, BatchOptions const& options = {});
 
 } // namespace libpreprocessor
 
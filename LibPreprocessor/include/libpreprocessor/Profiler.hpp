@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Token.hpp"
+#include "nodes/INode.hpp"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace libpreprocessor {
+
+struct ProfilerOptions
+{
+    // how many of the latest node visits are kept for `chrome_trace`, older ones being overwritten once it's full.
+    // none are kept by default, so a profiler attached to every render only ever holds one entry per node.
+    size_t traceEvents {};
+};
+
+// records how often every node was reached while rendering and how long it took including everything under it.
+// a profiler belongs to one thread at a time, and rendering without one doesn't measure anything.
+class Profiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry
+    {
+        Token::Location location {};
+        std::string kind {};
+        size_t hits {};
+        std::chrono::nanoseconds inclusive {};
+    };
+
+    class Scope
+    {
+    public:
+        // does nothing without a profiler, so unprofiled renders only pay for checking it.
+        Scope(Profiler* profiler, INode const* node) noexcept
+            : _profiler { profiler }
+            , _node { node }
+            , _begin { profiler != nullptr ? Clock::now() : Clock::time_point {} }
+        {
+        }
+
+        Scope(Scope const&) = delete;
+        Scope& operator=(Scope const&) = delete;
+
+        ~Scope()
+        {
+            if (_profiler != nullptr) _profiler->record(_node, _begin, Clock::now());
+        }
+
+    private:
+        Profiler* _profiler {};
+        INode const* _node {};
+        Clock::time_point _begin {};
+    };
+
+    explicit Profiler(ProfilerOptions const& options = {});
+
+    // one entry per source line and kind of node, the most expensive first.
+    std::vector<Entry> report() const;
+    std::string report_as_string() const;
+    // the kept node visits as complete events, oldest first, loadable by chrome://tracing or Perfetto.
+    std::string chrome_trace() const;
+    // how many node visits were overwritten, or never kept when tracing is off, since the last `clear`.
+    size_t dropped_events() const noexcept { return _recordedEvents - _events.size(); }
+
+    void clear();
+
+private:
+    struct Node
+    {
+        Token::Location location {};
+        std::string kind {};
+        size_t hits {};
+        std::chrono::nanoseconds inclusive {};
+    };
+
+    struct Event
+    {
+        size_t node {};
+        std::chrono::nanoseconds begin {};
+        std::chrono::nanoseconds duration {};
+    };
+
+    void record(INode const* node, Clock::time_point begin, Clock::time_point end);
+
+    ProfilerOptions _options {};
+    Clock::time_point _origin {};
+    std::vector<Node> _nodes {};
+    std::unordered_map<INode const*, size_t> _indices {};
+    // a ring buffer of at most `traceEvents`, where the next event goes at `_recordedEvents % traceEvents`.
+    std::vector<Event> _events {};
+    size_t _recordedEvents {};
+};
+
+} // namespace libpreprocessor
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Compiler.hpp"
+#include "Interpreter.hpp"
+
+#include <liberror/Result.hpp>
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace libpreprocessor {
+
+struct RenderCacheOptions
+{
+    // once the cached outputs and their keys take more than this, the least recently used ones are evicted.
+    size_t capacityBytes { 64zu * 1024 * 1024 };
+};
+
+// caches outputs by template and by the values of only the variables that template reads, so contexts which
+// differ in nothing the template looks at share a single render. the cache can be shared between threads.
+class RenderCache
+{
+public:
+    struct Statistics
+    {
+        size_t hits {};
+        size_t misses {};
+        size_t entries {};
+        size_t bytes {};
+    };
+
+    explicit RenderCache(RenderCacheOptions const& options = {});
+
+    // templates with %PRINT statements are always rendered, unless the context discards what they print. to tell
+    // which output a context would render, its provider is asked about every variable the template names.
+    liberror::Result<std::string> render(Template const& compiled, PreprocessorContext const& context);
+
+    Statistics statistics() const;
+    void clear();
+
+private:
+    struct Entry
+    {
+        uint64_t templateId {};
+        size_t hash {};
+        std::vector<std::string> values {};
+        std::string output {};
+        size_t bytes {};
+    };
+
+    using Entries = std::list<Entry>;
+
+    Entries::iterator find(uint64_t templateId, size_t hash, std::vector<std::string_view> const& values);
+    void insert(uint64_t templateId, size_t hash, std::vector<std::string_view> const& values, std::string const& output);
+    void erase(Entries::iterator entry);
+
+    RenderCacheOptions _options {};
+
+    mutable std::mutex _mutex {};
+    // most recently used first.
+    Entries _entries {};
+    std::unordered_multimap<size_t, Entries::iterator> _index {};
+    size_t _bytes {};
+    size_t _hits {};
+    size_t _misses {};
+};
+
+} // namespace libpreprocessor
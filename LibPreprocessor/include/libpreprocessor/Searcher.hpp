@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace libpreprocessor {
+
+// substring search for a needle known ahead of time, built once and reused for every haystack.
+// short needles are found by letting `memchr` (vectorized by the libc) find candidates for their first byte and
+// checking the last byte before comparing the rest, longer ones use Boyer-Moore-Horspool so they can skip ahead.
+class Searcher
+{
+public:
+    explicit Searcher(std::string needle)
+        : _needle { std::move(needle) }
+    {
+        _skip.fill(_needle.size());
+
+        for (auto index = 0zu; index + 1 < _needle.size(); index += 1)
+            _skip[static_cast<unsigned char>(_needle[index])] = _needle.size() - 1 - index;
+    }
+
+    std::string_view needle() const noexcept { return _needle; }
+
+    bool found_in(std::string_view haystack) const noexcept
+    {
+        if (_needle.empty()) return true;
+        if (haystack.size() < _needle.size()) return false;
+
+        return _needle.size() < horspool_threshold_g ? find_short(haystack) : find_long(haystack);
+    }
+
+private:
+    static constexpr size_t horspool_threshold_g = 8;
+
+    bool find_short(std::string_view haystack) const noexcept
+    {
+        auto const first = _needle.front();
+        auto const last = _needle.back();
+        auto const* const end = haystack.data() + haystack.size() - _needle.size() + 1;
+
+        for (auto const* candidate = haystack.data(); candidate < end; candidate += 1)
+        {
+            candidate = static_cast<char const*>(std::memchr(candidate, first, static_cast<size_t>(end - candidate)));
+            if (candidate == nullptr) return false;
+
+            if (candidate[_needle.size() - 1] == last && std::memcmp(candidate, _needle.data(), _needle.size()) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    bool find_long(std::string_view haystack) const noexcept
+    {
+        auto const last = _needle.size() - 1;
+
+        for (auto position = 0zu; position + last < haystack.size();)
+        {
+            auto const tail = haystack[position + last];
+
+            if (tail == _needle.back() && std::memcmp(haystack.data() + position, _needle.data(), last) == 0)
+                return true;
+
+            position += _skip[static_cast<unsigned char>(tail)];
+        }
+
+        return false;
+    }
+
+    std::string _needle {};
+    // how far the needle can move when the haystack byte under its last one is a given byte.
+    std::array<size_t, 256> _skip {};
+};
+
+} // namespace libpreprocessor
@@ -0,0 +1,512 @@
+#pragma once
+
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "Syntax.hpp"
+#include "TemplateImage.hpp"
+#include "nodes/Nodes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace libpreprocessor {
+
+// the image `save_image` makes of a template compiled from `source`, made without leaving constant evaluation.
+struct StaticImage
+{
+    std::string image {};
+    // what the parser refuses the template for, in which case `image` is left unfinished.
+    TemplateSyntaxError error {};
+};
+
+namespace internal {
+
+// a node `StaticParser` refers to, but didn't make.
+static constexpr size_t null_static_node_g = std::numeric_limits<size_t>::max();
+
+// what's read past the end of the tokens, which nothing the parser looks for is.
+static constexpr TokenView eof_token_g {};
+
+// a node of the tree `Parser` builds, as constant evaluation can hold it: nodes refer to the nodes they're made of
+// by their index in the parser's arena.
+struct StaticNode
+{
+    INode::Type type {};
+    IStatementNode::Type statement {};
+    std::pair<size_t, size_t> position {};
+    // the name of an operator, the value of a literal or the text of a content node.
+    std::string_view text {};
+    OperatorNode::Arity arity {};
+    // in the order `save_image` writes them: the condition and the branches of an `%IF`, the match and the branches
+    // of a `%SWITCH` or a case, the content of a `%PRINT`, the value of an expression or the operands of an operator.
+    std::array<size_t, 3> fields { null_static_node_g, null_static_node_g, null_static_node_g };
+    std::vector<size_t> nodes {};
+};
+
+// `Parser` over the tokens `scan` reads, taking and refusing the very same templates and building the very same tree,
+// other than refusing what `Parser` would crash on. the error messages aside, every branch here has its twin in
+// Parser.cpp, and a change to one is a change to both.
+class StaticParser
+{
+public:
+    constexpr explicit StaticParser(std::span<TokenView const> tokens) : _tokens { tokens } {}
+
+    constexpr size_t parse() { return parse({}); }
+
+    constexpr size_t parse(Parser::Context const& context)
+    {
+        auto root = null_static_node_g;
+
+        while (!eof())
+        {
+            auto const token = take();
+
+            switch (at(token).type)
+            {
+            case Token::Type::PERCENT: {
+                if (peek().type != Token::Type::KEYWORD)
+                    return fail(_cursor, "Expected a keyword after \"%\".");
+
+                auto const peekedEndToken = peek().data == "END";
+                auto const peekedElseOrDefault = context.child > context.parent && (peek().data == "ELSE" || peek().data == "DEFAULT");
+
+                if (peekedEndToken || peekedElseOrDefault)
+                {
+                    _cursor -= 1;
+                    return root;
+                }
+
+                auto const statementNode = parse_statement(context, take());
+                if (failed()) return null_static_node_g;
+
+                if (root == null_static_node_g)
+                    root = statementNode;
+                else
+                    _nodes[root].nodes.push_back(statementNode);
+
+                break;
+            }
+            case Token::Type::LEFT_SQUARE_BRACKET: {
+                if (!identify(context, token)) return null_static_node_g;
+
+                auto const expressionNode = make_node(INode::Type::EXPRESSION, token);
+                auto const value = parse({ context.parent, context.child, Parser::Context::Who::EXPRESSION });
+                if (failed()) return null_static_node_g;
+                _nodes[expressionNode].fields[0] = value;
+
+                if (eof())
+                    return fail(token, "Expected \"]\", but the template ended.");
+                if (!(peek().type == Token::Type::OPERATOR || peek().type == Token::Type::RIGHT_SQUARE_BRACKET))
+                    return fail(_cursor, "Expected \"]\".");
+
+                root = expressionNode;
+
+                break;
+            }
+            case Token::Type::RIGHT_SQUARE_BRACKET: {
+                if (!identify(context, token)) return null_static_node_g;
+
+                if (!(eof() || peek().type == Token::Type::OPERATOR))
+                {
+                    if (!requires_trailing_colon(context, _cursor)) return null_static_node_g;
+                    return root;
+                }
+
+                break;
+            }
+            case Token::Type::LEFT_ANGLE_BRACKET: {
+                if (!identify(context, token)) return null_static_node_g;
+
+                auto const literalNode = make_node(INode::Type::LITERAL, token);
+                _nodes[literalNode].text = at(take()).data;
+
+                if (eof())
+                    return fail(token, "Expected \">\", but the template ended.");
+                if (peek().type != Token::Type::RIGHT_ANGLE_BRACKET)
+                    return fail(_cursor, "Expected \">\".");
+
+                root = literalNode;
+
+                break;
+            }
+            case Token::Type::RIGHT_ANGLE_BRACKET: {
+                if (!identify(context, token)) return null_static_node_g;
+                if (!(eof() || peek().type == Token::Type::OPERATOR))
+                    return root;
+                break;
+            }
+            case Token::Type::COLON: {
+                if (!identify(context, token)) return null_static_node_g;
+                root = make_node(INode::Type::SCOPE, token);
+                break;
+            }
+            case Token::Type::OPERATOR: {
+                if (!identify(context, token)) return null_static_node_g;
+                return parse_operator(context, token, root);
+            }
+            case Token::Type::CONTENT: {
+                auto const contentNode = make_node(INode::Type::CONTENT, token);
+                _nodes[contentNode].text = at(token).data;
+
+                if (root == null_static_node_g)
+                    root = contentNode;
+                else
+                    _nodes[root].nodes.push_back(contentNode);
+
+                break;
+            }
+
+            case Token::Type::KEYWORD:
+            case Token::Type::IDENTIFIER:
+            case Token::Type::LITERAL:
+
+            case Token::Type::BEGIN__:
+            case Token::Type::END__:
+            default: {
+                return fail(token, "Unexpected token was reached.");
+            }
+            }
+        }
+
+        return root;
+    }
+
+    constexpr TemplateSyntaxError const& error() const noexcept { return _error; }
+    constexpr std::vector<StaticNode> const& nodes() const noexcept { return _nodes; }
+
+private:
+    constexpr bool eof() const noexcept { return _cursor == _tokens.size(); }
+    constexpr TokenView const& at(size_t token) const noexcept { return token < _tokens.size() ? _tokens[token] : eof_token_g; }
+    constexpr TokenView const& peek() const noexcept { return at(_cursor); }
+    // past the end, where `Parser` would take from an empty stack, the end is taken over and over instead.
+    constexpr size_t take() noexcept { return eof() ? _cursor : _cursor++; }
+    constexpr bool failed() const noexcept { return static_cast<bool>(_error); }
+
+    constexpr size_t fail(size_t token, std::string_view message)
+    {
+        if (!failed())
+        {
+            auto const line = _tokens.empty() ? 0 : _tokens[std::min(token, _tokens.size() - 1)].position.first;
+            _error = { line, token, message };
+        }
+
+        return null_static_node_g;
+    }
+
+    constexpr size_t make_node(INode::Type type, size_t token)
+    {
+        _nodes.push_back({ .type = type, .position = at(token).position });
+        return _nodes.size() - 1;
+    }
+
+    constexpr size_t make_statement(IStatementNode::Type type, size_t token)
+    {
+        auto const statementNode = make_node(INode::Type::STATEMENT, token);
+        _nodes[statementNode].statement = type;
+        return statementNode;
+    }
+
+    constexpr bool is_expression(size_t node) const { return _nodes[node].type == INode::Type::EXPRESSION; }
+
+    constexpr bool identify(Parser::Context const& context, size_t token)
+    {
+        if (context.whois == Parser::Context::Who::BEGIN__ || context.whois == Parser::Context::Who::END__)
+        {
+            fail(token, "A stray token was reached.");
+            return false;
+        }
+
+        return true;
+    }
+
+    constexpr bool requires_trailing_colon(Parser::Context const& context, size_t token)
+    {
+        switch (context.whois)
+        {
+        case Parser::Context::Who::IF_STATEMENT:
+        case Parser::Context::Who::ELSE_STATEMENT:
+        case Parser::Context::Who::SWITCH_STATEMENT:
+        case Parser::Context::Who::CASE_STATEMENT: {
+            if (at(token).type != Token::Type::COLON)
+            {
+                fail(token, "Expected \":\".");
+                return false;
+            }
+
+            break;
+        }
+
+        case Parser::Context::Who::PRINT_STATEMENT:
+        case Parser::Context::Who::EXPRESSION: {
+            break;
+        }
+
+        case Parser::Context::Who::BEGIN__:
+        case Parser::Context::Who::END__:
+        default: {
+            fail(token, "Context::whois had an invalid value.");
+            return false;
+        }
+        }
+
+        return true;
+    }
+
+    // takes the `%END` closing the statement at `token`, which is where it fails otherwise.
+    constexpr bool take_end(size_t token, std::string_view message)
+    {
+        if (eof() || (take(), peek().data != "END"))
+        {
+            fail(token, message);
+            return false;
+        }
+
+        take();
+        return true;
+    }
+
+    constexpr size_t parse_operator(Parser::Context const& context, size_t token, size_t node)
+    {
+        auto const operatorNode = make_node(INode::Type::OPERATOR, token);
+        _nodes[operatorNode].text = at(token).data;
+        _nodes[operatorNode].arity = std::ranges::find(operator_g, at(token).data, &decltype(operator_g)::value_type::first)->second;
+
+        // `Parser` dereferences the missing operand, so what it would crash on is refused here.
+        auto const fnAsExpression = [this, token] (size_t operand) {
+            if (failed()) return null_static_node_g;
+            if (operand == null_static_node_g) return fail(token, "An operator is missing an operand.");
+            if (is_expression(operand)) return operand;
+
+            auto const expressionNode = make_node(INode::Type::EXPRESSION, token);
+            _nodes[expressionNode].position = _nodes[operand].position;
+            _nodes[expressionNode].fields[0] = operand;
+            return expressionNode;
+        };
+
+        if (node == null_static_node_g)
+        {
+            _nodes[operatorNode].fields[0] = fnAsExpression(parse({ context.parent, context.child, context.whois }));
+        }
+        else switch (_nodes[node].type)
+        {
+        case INode::Type::LITERAL:
+            _nodes[operatorNode].fields[0] = fnAsExpression(node);
+            break;
+        case INode::Type::EXPRESSION:
+            _nodes[operatorNode].fields[0] = node;
+            break;
+
+        default: {
+            return fail(token, "An operator doesn't follow an operand.");
+        }
+        }
+
+        if (failed()) return null_static_node_g;
+
+        if (_nodes[operatorNode].arity == OperatorNode::Arity::BINARY)
+            _nodes[operatorNode].fields[1] = fnAsExpression(parse({ context.parent, context.child + 1, context.whois }));
+
+        return failed() ? null_static_node_g : operatorNode;
+    }
+
+    constexpr size_t parse_statement(Parser::Context const& context, size_t token)
+    {
+        using Who = Parser::Context::Who;
+
+        auto const keyword = at(token).data;
+
+        // parses the next field of `node` with `fieldContext`, and tells whether it went through.
+        auto const fnParseField = [this] (size_t node, size_t field, Parser::Context const& fieldContext) {
+            auto const value = parse(fieldContext);
+            if (failed()) return false;
+            _nodes[node].fields[field] = value;
+            return true;
+        };
+
+        if (keyword == "IF")
+        {
+            auto const ifStatementNode = make_statement(IStatementNode::Type::IF, token);
+            if (!fnParseField(ifStatementNode, 0, { context.parent, context.child, Who::IF_STATEMENT })) return null_static_node_g;
+
+            auto const condition = _nodes[ifStatementNode].fields[0];
+            if (condition == null_static_node_g)
+                return fail(token, "An \"%IF\" statement didn't had a condition.");
+            if (!is_expression(condition))
+                return fail(token, "\"%IF\" statement expects an expression.");
+
+            if (!fnParseField(ifStatementNode, 1, { context.child, context.child + 1, Who::IF_STATEMENT })) return null_static_node_g;
+            if (!fnParseField(ifStatementNode, 2, { context.child, context.parent, Who::IF_STATEMENT })) return null_static_node_g;
+
+            if (!take_end(token, "An \"%IF\" statement missing its \"%END\" was reached.")) return null_static_node_g;
+
+            return ifStatementNode;
+        }
+
+        if (keyword == "ELSE")
+        {
+            return parse({ context.parent, context.child + 1, Who::ELSE_STATEMENT });
+        }
+
+        if (keyword == "SWITCH")
+        {
+            auto const switchStatementNode = make_statement(IStatementNode::Type::SWITCH, token);
+            if (!fnParseField(switchStatementNode, 0, { context.parent, context.child + 1, Who::SWITCH_STATEMENT })) return null_static_node_g;
+
+            auto const match = _nodes[switchStatementNode].fields[0];
+            if (match != null_static_node_g && !is_expression(match))
+                return fail(token, "\"%SWITCH\" statement expects an expression.");
+            if (match == null_static_node_g)
+                return fail(token, "An \"%SWITCH\" statement didn't had a expression to match.");
+
+            if (!fnParseField(switchStatementNode, 1, { context.child, context.child + 1, Who::SWITCH_STATEMENT })) return null_static_node_g;
+            if (!fnParseField(switchStatementNode, 2, { context.child, context.parent, Who::SWITCH_STATEMENT })) return null_static_node_g;
+
+            if (_nodes[switchStatementNode].fields[1] == null_static_node_g && _nodes[switchStatementNode].fields[2] == null_static_node_g)
+                return fail(token, "An \"%SWITCH\" statement must have atleast a %DEFAULT case.");
+            if (!take_end(token, "An \"%SWITCH\" statement missing its \"%END\" was reached.")) return null_static_node_g;
+
+            return switchStatementNode;
+        }
+
+        if (keyword == "CASE")
+        {
+            auto const switchCaseNode = make_statement(IStatementNode::Type::SWITCH_CASE, token);
+            if (!fnParseField(switchCaseNode, 0, { context.parent, context.child + 1, Who::CASE_STATEMENT })) return null_static_node_g;
+
+            auto const match = _nodes[switchCaseNode].fields[0];
+            if (match == null_static_node_g)
+                return fail(token, "An \"%CASE\" statement didn't had a expression to match.");
+            if (!is_expression(match))
+                return fail(token, "\"%CASE\" expects an expression.");
+
+            if (!fnParseField(switchCaseNode, 1, { context.child, context.child + 1, Who::CASE_STATEMENT })) return null_static_node_g;
+            if (!take_end(token, "An \"%CASE\" statement missing its \"%END\" was reached.")) return null_static_node_g;
+
+            return switchCaseNode;
+        }
+
+        if (keyword == "DEFAULT")
+        {
+            auto const switchCaseNode = make_statement(IStatementNode::Type::SWITCH_CASE, token);
+            if (!fnParseField(switchCaseNode, 1, { context.child, context.child + 1, Who::CASE_STATEMENT })) return null_static_node_g;
+
+            auto const literalNode = make_node(INode::Type::LITERAL, token);
+            _nodes[literalNode].text = "DEFAULT";
+            _nodes[switchCaseNode].fields[0] = literalNode;
+
+            if (_nodes[switchCaseNode].fields[1] == null_static_node_g)
+                return fail(token, "An \"%DEFAULT\" statement didn't had a body.");
+            if (!take_end(token, "An \"%DEFAULT\" statement missing its \"%END\" was reached.")) return null_static_node_g;
+
+            return switchCaseNode;
+        }
+
+        if (keyword == "PRINT")
+        {
+            auto const printNode = make_statement(IStatementNode::Type::PRINT, token);
+            if (!fnParseField(printNode, 0, { context.parent, context.child, Who::PRINT_STATEMENT })) return null_static_node_g;
+
+            auto const content = _nodes[printNode].fields[0];
+            if (content == null_static_node_g)
+                return fail(token, "\"%PRINT\" statement didn't had an expression.");
+            if (!is_expression(content))
+                return fail(token, "\"%PRINT\" expects an expression.");
+
+            return printNode;
+        }
+
+        return fail(token, "An unexpected keyword was reached.");
+    }
+
+    std::span<TokenView const> _tokens {};
+    size_t _cursor {};
+    std::vector<StaticNode> _nodes {};
+    TemplateSyntaxError _error {};
+};
+
+// the twin of `write_node` in TemplateImage.cpp, for the nodes of a `StaticParser`.
+constexpr void write_static_node(std::span<StaticNode const> nodes, size_t head, ImageWriter& writer)
+{
+    if (head == null_static_node_g)
+    {
+        writer.write_byte(null_node_g);
+        return;
+    }
+
+    auto const& node = nodes[head];
+    // how many of `fields` the node has.
+    auto fields = 0zu;
+
+    writer.write_byte(static_cast<uint8_t>(node.type));
+    writer.write_file(unknown_file_location_g);
+    writer.write_integer(node.position.first);
+    writer.write_integer(node.position.second);
+
+    switch (node.type)
+    {
+    case INode::Type::STATEMENT: {
+        writer.write_byte(static_cast<uint8_t>(node.statement));
+        fields = node.statement == IStatementNode::Type::PRINT ? 1 : node.statement == IStatementNode::Type::SWITCH_CASE ? 2 : 3;
+        break;
+    }
+    case INode::Type::EXPRESSION: {
+        fields = 1;
+        break;
+    }
+    case INode::Type::OPERATOR: {
+        writer.write_string(node.text);
+        writer.write_byte(static_cast<uint8_t>(node.arity));
+        fields = 2;
+        break;
+    }
+    case INode::Type::LITERAL:
+    case INode::Type::CONTENT: {
+        writer.write_string(node.text);
+        break;
+    }
+    case INode::Type::SCOPE: {
+        break;
+    }
+
+    case INode::Type::CONDITION:
+
+    case INode::Type::BEGIN__:
+    case INode::Type::END__:
+    default: {
+        break;
+    }
+    }
+
+    for (auto index = 0zu; index < fields; index += 1)
+        write_static_node(nodes, node.fields[index], writer);
+
+    writer.write_integer(node.nodes.size());
+
+    for (auto const subnode : node.nodes)
+        write_static_node(nodes, subnode, writer);
+}
+
+} // namespace internal
+
+// reads `source` as `compile(source)` does, into the image `save_image` makes of what that compiles. `compile` can
+// still refuse the image once it's loaded, for what it only finds past the parser.
+constexpr StaticImage save_static_image(std::string_view source)
+{
+    auto const tokens = scan(source);
+
+    internal::StaticParser parser { tokens };
+    auto const head = parser.parse();
+    if (parser.error()) return { .error = parser.error() };
+
+    internal::ImageWriter nodes {};
+    internal::write_static_node(parser.nodes(), head, nodes);
+    return { .image = internal::finish_image(nodes) };
+}
+
+} // namespace libpreprocessor
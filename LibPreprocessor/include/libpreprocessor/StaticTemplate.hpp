@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Compiler.hpp"
+#include "StaticParser.hpp"
+#include "Syntax.hpp"
+#include "TemplateImage.hpp"
+
+#include <liberror/Result.hpp>
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+namespace libpreprocessor {
+
+// a string literal that can be passed as a template argument.
+template <size_t N>
+struct FixedString
+{
+    constexpr FixedString(char const (&string)[N]) { std::ranges::copy(string, value); }
+
+    constexpr std::string_view view() const noexcept { return { value, N - 1 }; }
+
+    char value[N] {};
+};
+
+namespace internal {
+
+// deliberately not constexpr: reaching it while checking a template during compilation is what turns a syntax
+// error into a compile error. compilers that print the arguments of the failing call show the line and the message,
+// otherwise `check_syntax` gives them for the template the diagnostic names.
+inline void template_syntax_error(size_t, char const*) {}
+
+// the image of `Source`, saved twice: once to size the array and once to fill it, since nothing allocated during
+// constant evaluation outlives it.
+template <FixedString Source>
+consteval auto static_image()
+{
+    if (auto const error = check_syntax(Source.view())) template_syntax_error(error.line, error.message.data());
+
+    constexpr auto size = save_static_image(Source.view()).image.size();
+    auto const saved = save_static_image(Source.view());
+    if (saved.error) template_syntax_error(saved.error.line, saved.error.message.data());
+
+    std::array<char, size> image {};
+    std::ranges::copy(saved.image, image.begin());
+    return image;
+}
+
+} // namespace internal
+
+// compiles a template written as a string literal. it's checked and parsed while the program is compiled, into the
+// image `save_image` would make of it, which is compiled into the program. the nodes a template is made of live on
+// the heap, which constant evaluation can't hand over to the program, so the image is still loaded, but nothing is
+// lexed or parsed at runtime, and it's only loaded once, the first time it's used, every call after sharing it.
+template <FixedString Source>
+liberror::Result<Template> const& compile()
+{
+    static constexpr auto image = internal::static_image<Source>();
+    static liberror::Result<Template> const compiled = load_image({ image.data(), image.size() });
+    return compiled;
+}
+
+} // namespace libpreprocessor
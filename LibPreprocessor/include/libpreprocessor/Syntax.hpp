@@ -0,0 +1,289 @@
+#pragma once
+
+#include "Lexer.hpp"
+#include "Token.hpp"
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace libpreprocessor {
+
+struct TemplateSyntaxError
+{
+    // of the token the error was found at, counted from one over every line of the source, empty ones included.
+    size_t line {};
+    // the index of that token.
+    size_t token {};
+    std::string_view message {};
+
+    constexpr explicit operator bool() const noexcept { return !message.empty(); }
+};
+
+// how a statement is written: whether an expression and a colon follow its keyword, and what it does to blocks.
+struct StatementRule
+{
+    enum class Colon
+    {
+        BEGIN__,
+        NONE,
+        OPTIONAL,
+        REQUIRED,
+        END__
+    };
+
+    enum class Block
+    {
+        BEGIN__,
+        NONE,
+        OPENS,
+        // takes over the innermost block, in place of the statement that opened it.
+        CONTINUES,
+        CLOSES,
+        END__
+    };
+
+    // how it stands to the cases of a %SWITCH, whose block directly holds nothing but cases until its last one.
+    enum class Cases
+    {
+        BEGIN__,
+        NONE,
+        HOLDS,
+        IS,
+        IS_LAST,
+        END__
+    };
+
+    std::string_view keyword {};
+    bool expression {};
+    Colon colon {};
+    Block block {};
+    Cases cases { Cases::NONE };
+    // the statement of the innermost open block it has to go in, if any, and what's wrong when it doesn't.
+    std::string_view within {};
+    std::string_view misplaced {};
+    // whether it has to be followed by a colon or by content before the next statement.
+    bool body {};
+};
+
+static constexpr std::array statement_rules_g {
+    StatementRule { .keyword = "IF", .expression = true, .colon = StatementRule::Colon::REQUIRED, .block = StatementRule::Block::OPENS },
+    StatementRule {
+        .keyword = "ELSE", .colon = StatementRule::Colon::OPTIONAL, .block = StatementRule::Block::CONTINUES,
+        .within = "IF", .misplaced = "An \"%ELSE\" doesn't follow an \"%IF\"."
+    },
+    StatementRule {
+        .keyword = "SWITCH", .expression = true, .colon = StatementRule::Colon::REQUIRED, .block = StatementRule::Block::OPENS,
+        .cases = StatementRule::Cases::HOLDS
+    },
+    StatementRule {
+        .keyword = "CASE", .expression = true, .colon = StatementRule::Colon::REQUIRED, .block = StatementRule::Block::OPENS,
+        .cases = StatementRule::Cases::IS
+    },
+    StatementRule {
+        .keyword = "DEFAULT", .colon = StatementRule::Colon::OPTIONAL, .block = StatementRule::Block::OPENS,
+        .cases = StatementRule::Cases::IS_LAST, .within = "SWITCH", .misplaced = "A \"%DEFAULT\" isn't directly within a \"%SWITCH\".",
+        .body = true
+    },
+    StatementRule { .keyword = "PRINT", .expression = true, .colon = StatementRule::Colon::NONE, .block = StatementRule::Block::NONE },
+    StatementRule { .keyword = "END", .colon = StatementRule::Colon::NONE, .block = StatementRule::Block::CLOSES },
+};
+
+namespace internal {
+
+// consumes the bracketed expression at `index`, where operands and operators take turns, leaving `index` at the
+// token it failed at otherwise.
+constexpr std::string_view skip_expression(std::span<TokenView const> tokens, size_t& index)
+{
+    auto const fnIs = [tokens] (size_t at, Token::Type type) { return at < tokens.size() && tokens[at].type == type; };
+
+    if (!fnIs(index, Token::Type::LEFT_SQUARE_BRACKET)) return "A statement is missing its expression.";
+
+    size_t depth = 0;
+    auto expectsOperand = true;
+
+    for (; index < tokens.size(); index += 1)
+    {
+        switch (tokens[index].type)
+        {
+        case Token::Type::LEFT_SQUARE_BRACKET: {
+            if (!expectsOperand) return "An operand in an expression isn't preceded by an operator.";
+            depth += 1;
+            break;
+        }
+        case Token::Type::RIGHT_SQUARE_BRACKET: {
+            if (expectsOperand) return "An expression is missing an operand.";
+            depth -= 1;
+
+            if (depth == 0)
+            {
+                index += 1;
+                return {};
+            }
+
+            break;
+        }
+        case Token::Type::LEFT_ANGLE_BRACKET: {
+            if (!expectsOperand) return "An operand in an expression isn't preceded by an operator.";
+            // whatever token follows is the value of the literal.
+            if (!fnIs(index + 2, Token::Type::RIGHT_ANGLE_BRACKET)) return "A literal isn't closed by \">\".";
+            index += 2;
+            expectsOperand = false;
+            break;
+        }
+        case Token::Type::OPERATOR: {
+            auto const unary = std::ranges::find(operator_g, tokens[index].data, &decltype(operator_g)::value_type::first)->second == OperatorNode::Arity::UNARY;
+            // a unary operator comes before its operand, a binary one between both of its operands.
+            if (unary != expectsOperand) return "An operator in an expression is missing an operand.";
+            expectsOperand = true;
+            break;
+        }
+
+        case Token::Type::PERCENT:
+        case Token::Type::RIGHT_ANGLE_BRACKET:
+        case Token::Type::COLON:
+        case Token::Type::KEYWORD:
+        case Token::Type::LITERAL:
+        case Token::Type::CONTENT:
+        case Token::Type::IDENTIFIER:
+
+        case Token::Type::BEGIN__:
+        case Token::Type::END__:
+        default: {
+            return "An expression isn't closed by \"]\".";
+        }
+        }
+    }
+
+    return "An expression isn't closed by \"]\".";
+}
+
+constexpr TemplateSyntaxError check_tokens(std::span<TokenView const> tokens)
+{
+    struct Block
+    {
+        // of the statement opening the block.
+        size_t token {};
+        std::string_view keyword {};
+        bool casesOnly {};
+    };
+
+    std::vector<Block> blocks {};
+
+    auto const fnError = [tokens] (size_t at, std::string_view message) {
+        at = std::min(at, tokens.size() - 1);
+        return TemplateSyntaxError { tokens[at].position.first, at, message };
+    };
+
+    auto const fnIs = [tokens] (size_t at, Token::Type type) { return at < tokens.size() && tokens[at].type == type; };
+
+    for (auto index = 0zu; index < tokens.size();)
+    {
+        auto const statement = index;
+
+        auto const casesOnly = !blocks.empty() && blocks.back().casesOnly;
+
+        if (fnIs(index, Token::Type::CONTENT))
+        {
+            if (casesOnly) return fnError(index, "A \"%SWITCH\" holds something other than a case before its \"%DEFAULT\".");
+            index += 1;
+            continue;
+        }
+
+        if (!fnIs(index, Token::Type::PERCENT))
+            return fnError(index, "A line of content starts with what only statements can hold.");
+        if (!fnIs(index + 1, Token::Type::KEYWORD))
+            return fnError(statement, "A \"%\" isn't followed by a known statement.");
+
+        auto const& rule = *std::ranges::find(statement_rules_g, tokens[index + 1].data, &StatementRule::keyword);
+        index += 2;
+
+        auto const isCase = rule.cases == StatementRule::Cases::IS || rule.cases == StatementRule::Cases::IS_LAST;
+        if (casesOnly && !isCase && rule.block != StatementRule::Block::CLOSES)
+            return fnError(statement, "A \"%SWITCH\" holds something other than a case before its \"%DEFAULT\".");
+
+        if (rule.expression)
+        {
+            if (auto const message = skip_expression(tokens, index); !message.empty()) return fnError(index, message);
+        }
+
+        switch (rule.colon)
+        {
+        case StatementRule::Colon::REQUIRED: {
+            if (!fnIs(index, Token::Type::COLON)) return fnError(statement, "A statement isn't followed by \":\".");
+            index += 1;
+            break;
+        }
+        case StatementRule::Colon::OPTIONAL: {
+            if (fnIs(index, Token::Type::COLON)) index += 1;
+            else if (rule.body && !fnIs(index, Token::Type::CONTENT)) return fnError(statement, "A statement is missing its body.");
+            break;
+        }
+        case StatementRule::Colon::NONE: {
+            break;
+        }
+
+        case StatementRule::Colon::BEGIN__:
+        case StatementRule::Colon::END__:
+        default: {
+            break;
+        }
+        }
+
+        if (!rule.within.empty() && (blocks.empty() || blocks.back().keyword != rule.within))
+            return fnError(statement, rule.misplaced);
+
+        switch (rule.block)
+        {
+        case StatementRule::Block::OPENS: {
+            if (rule.cases == StatementRule::Cases::IS_LAST) blocks.back().casesOnly = false;
+            blocks.push_back({ statement, rule.keyword, rule.cases == StatementRule::Cases::HOLDS });
+            break;
+        }
+        case StatementRule::Block::CONTINUES: {
+            blocks.back().keyword = rule.keyword;
+            break;
+        }
+        case StatementRule::Block::CLOSES: {
+            if (blocks.empty()) return fnError(statement, "An \"%END\" doesn't close any statement.");
+            blocks.pop_back();
+            break;
+        }
+        case StatementRule::Block::NONE: {
+            break;
+        }
+
+        case StatementRule::Block::BEGIN__:
+        case StatementRule::Block::END__:
+        default: {
+            break;
+        }
+        }
+    }
+
+    if (!blocks.empty()) return fnError(blocks.back().token, "A statement is missing its \"%END\".");
+
+    return {};
+}
+
+} // namespace internal
+
+// checks how the statements of a template are put together, by the rules in `statement_rules_g`: that every `%`
+// names a statement, that it has the expression and the colon it needs, that `%ELSE` only follows an `%IF` and that
+// every block is closed by an `%END`. templates are read by `scan`, the lexer's own rules, so a template can be
+// checked while the program is compiled. it's stricter than `compile`, which reads past a stray `%END` or a second
+// `%ELSE`, but everything it accepts, `compile` accepts too.
+constexpr TemplateSyntaxError check_syntax(std::span<TokenView const> tokens)
+{
+    return internal::check_tokens(tokens);
+}
+
+constexpr TemplateSyntaxError check_syntax(std::string_view source)
+{
+    auto const tokens = scan(source);
+    return check_syntax(std::span<TokenView const> { tokens });
+}
+
+} // namespace libpreprocessor
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Compiler.hpp"
+
+#include <liberror/Result.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace libpreprocessor {
+
+// a template turned into bytes by `save_image`, as `libpreprocessor_embed_templates` compiles it into a program.
+struct EmbeddedTemplate
+{
+    // the template's path, relative to the directory it was embedded from.
+    std::string_view name {};
+    std::string_view image {};
+};
+
+// the parsed tree of a template as bytes, which `load_image` turns back into a template without reading or parsing
+// anything. images are only meant to be loaded by the version of the library that saved them.
+liberror::Result<std::string> save_image(Template const& compiled);
+liberror::Result<Template> load_image(std::string_view image);
+liberror::Result<Template> load_embedded(std::span<EmbeddedTemplate const> templates, std::string_view name);
+
+namespace internal {
+
+// bumped whenever the layout changes, so stale images are refused instead of misread.
+static constexpr std::string_view image_magic_g = "LPPI";
+static constexpr uint64_t image_version_g = 1;
+
+// a missing node, which no `INode::Type` is since they start at `BEGIN__`.
+static constexpr uint8_t null_node_g = 0;
+
+// constexpr so templates written as string literals can be turned into images while the program is compiled.
+class ImageWriter
+{
+public:
+    constexpr void write_byte(uint8_t byte) { _bytes += static_cast<char>(byte); }
+
+    // little endian whatever the host is, so an image saved while cross compiling loads on the target.
+    constexpr void write_integer(uint64_t integer)
+    {
+        for (auto index = 0zu; index < sizeof(integer); index += 1)
+            write_byte(static_cast<uint8_t>(integer >> (index * 8)));
+    }
+
+    constexpr void write_string(std::string_view string)
+    {
+        write_integer(string.size());
+        _bytes += string;
+    }
+
+    // the nodes of a template are all parsed from the same file, so its path is written once and referred to by index.
+    constexpr void write_file(std::string_view file)
+    {
+        auto const found = std::ranges::find(_files, file);
+        write_integer(static_cast<uint64_t>(found - _files.begin()));
+        if (found == _files.end()) _files.push_back(std::string { file });
+    }
+
+    constexpr std::vector<std::string> const& files() const noexcept { return _files; }
+    // no `take`, moving a short string out isn't something GCC 12 can do while evaluating constants.
+    constexpr std::string const& bytes() const noexcept { return _bytes; }
+
+private:
+    std::string _bytes {};
+    std::vector<std::string> _files {};
+};
+
+// laid out as the magic, the version, the files the nodes were parsed from and then the nodes, depth first.
+constexpr std::string finish_image(ImageWriter const& nodes)
+{
+    ImageWriter writer {};
+
+    for (auto const character : image_magic_g)
+        writer.write_byte(static_cast<uint8_t>(character));
+
+    writer.write_integer(image_version_g);
+    writer.write_integer(nodes.files().size());
+
+    for (auto const& file : nodes.files())
+        writer.write_string(file);
+
+    return writer.bytes() + nodes.bytes();
+}
+
+} // namespace internal
+
+} // namespace libpreprocessor
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Compiler.hpp"
+#include "Interpreter.hpp"
+
+#include <liberror/Result.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace libpreprocessor {
+
+struct TemplateRegistryOptions
+{
+    // a file whose modification time or size changed is hashed as well, and only compiled again when its contents
+    // changed too, so rewriting a file with what it already held (as deployments tend to) costs no compilation.
+    bool hashContents {};
+    // whether lookups check if the file changed, which is left to whoever calls `refresh` (like `TemplateWatcher`)
+    // when it's off, so lookups that hit make no system call at all.
+    bool revalidate { true };
+};
+
+// caches templates compiled from files by their path, checking with a `stat` on every lookup whether the file
+// changed since it was compiled and compiling it again only then. the registry can be shared between threads:
+// paths are spread over several locks, which lookups only share, and which are only held exclusively to store a
+// template compiled outside of them.
+class TemplateRegistry
+{
+public:
+    struct Statistics
+    {
+        size_t hits {};
+        size_t compilations {};
+        size_t entries {};
+    };
+
+    explicit TemplateRegistry(TemplateRegistryOptions const& options = {});
+
+    // a template handed out stays valid for as long as it's held, even if the registry compiles a newer one or
+    // forgets about it.
+    liberror::Result<std::shared_ptr<Template const>> find(std::filesystem::path const& path);
+    liberror::Result<std::string> process(std::filesystem::path const& path, PreprocessorContext const& context);
+
+    // compiles the template of `path` again, unless the registry doesn't hold it, for whoever knows its file changed.
+    // a file rewritten within the resolution of its modification time may still look the same to a `stat`, so it's
+    // compiled whatever it looks like (or hashed first with `hashContents`). the template is swapped in once
+    // compiled, and if that fails the previous one is kept.
+    liberror::Result<void> refresh(std::filesystem::path const& path);
+
+    void erase(std::filesystem::path const& path);
+    void clear();
+    Statistics statistics() const;
+
+private:
+    // what a template was compiled from, as of compiling it.
+    struct Source
+    {
+        std::filesystem::file_time_type modified {};
+        uintmax_t size {};
+        size_t hash {};
+    };
+
+    struct Entry
+    {
+        std::shared_ptr<Template const> compiled {};
+        Source source {};
+    };
+
+    struct Shard
+    {
+        mutable std::shared_mutex mutex {};
+        std::unordered_map<std::string, Entry> entries {};
+    };
+
+    static constexpr size_t shard_count_g = 16;
+
+    static liberror::Result<Source> inspect(std::filesystem::path const& path);
+
+    Shard& shard_of(std::string const& key);
+    // compiles the file unless it hashes the same as what `cached` was compiled from.
+    liberror::Result<Entry> load(std::filesystem::path const& path, Source const& source, Entry const* cached);
+
+    TemplateRegistryOptions _options {};
+    std::array<Shard, shard_count_g> _shards {};
+    std::atomic<size_t> _hits {};
+    std::atomic<size_t> _compilations {};
+};
+
+} // namespace libpreprocessor
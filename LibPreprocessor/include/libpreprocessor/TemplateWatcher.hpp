@@ -0,0 +1,71 @@
+#pragma once
+
+#include "TemplateRegistry.hpp"
+
+#include <liberror/Result.hpp>
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace libpreprocessor {
+
+struct TemplateWatcherOptions
+{
+    // told about every file that changed but failed to compile, whose previous template is kept.
+    std::function<void(std::filesystem::path const& path, std::string_view message)> onError {};
+};
+
+// keeps a registry up to date from a thread of its own, which compiles watched files again as soon as they're
+// written and swaps them into the registry. renders already holding a template finish with it, and a registry
+// created with `revalidate` off no longer has to `stat` anything on lookups that hit. files are told apart by
+// the paths they're watched through, so they should be looked up by those same paths. the registry has to outlive
+// the watcher. only supported on Linux, where it's built on inotify.
+class TemplateWatcher
+{
+public:
+    static liberror::Result<std::unique_ptr<TemplateWatcher>> create(TemplateRegistry& registry, TemplateWatcherOptions options = {});
+
+    TemplateWatcher(TemplateWatcher const&) = delete;
+    TemplateWatcher& operator=(TemplateWatcher const&) = delete;
+
+    ~TemplateWatcher();
+
+    // a directory has every file directly inside it watched, those in its subdirectories aren't. files are watched
+    // through their directory, so replacing one (as editors and deployments tend to) doesn't stop watching it.
+    liberror::Result<void> watch(std::filesystem::path const& path);
+
+private:
+    struct Watch
+    {
+        std::filesystem::path directory {};
+        bool everything {};
+        std::set<std::string, std::less<>> files {};
+    };
+
+    TemplateWatcher(TemplateRegistry& registry, TemplateWatcherOptions options, int inotify, int wakeup);
+
+    void run(std::stop_token const& token);
+    void refresh(std::filesystem::path const& path);
+    void refresh_everything();
+
+    TemplateRegistry& _registry;
+    TemplateWatcherOptions _options {};
+    int _inotify { -1 };
+    // written to when the watcher is destroyed, so the thread stops waiting for events.
+    int _wakeup { -1 };
+
+    std::mutex _mutex {};
+    // by inotify watch descriptor, every one of them being a directory.
+    std::unordered_map<int, Watch> _watches {};
+
+    std::jthread _thread {};
+};
+
+} // namespace libpreprocessor
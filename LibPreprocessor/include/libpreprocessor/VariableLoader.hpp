@@ -0,0 +1,22 @@
+#pragma once
+
+#include "VariableMap.hpp"
+
+#include <liberror/Result.hpp>
+
+#include <filesystem>
+#include <string_view>
+
+namespace libpreprocessor {
+
+// every function below adds to `variables`, with later definitions replacing earlier ones and both replacing
+// what `variables` already held, so several sources can be layered by loading them in order.
+
+// lines of the form `NAME=VALUE`, optionally prefixed by `export`. blank lines and those starting with `#` are
+// skipped, whitespace around the name and the value is trimmed, and a value wrapped in matching quotes loses them.
+liberror::Result<void> parse_variables(std::string_view source, VariableMap& variables);
+// maps the file into memory instead of reading it, and parses it in place.
+liberror::Result<void> load_variables(std::filesystem::path const& path, VariableMap& variables);
+void load_process_environment(VariableMap& variables);
+
+} // namespace libpreprocessor
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "VariableValue.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace libpreprocessor {
+
+// open-addressing (linear probing) hash map from variable names to their values.
+// entries are kept densely packed in insertion order, buckets only store the entry index and its hash,
+// so a lookup by `std::string_view` never allocates and probes the table a single time. values are shared rather
+// than copied when the map is.
+class VariableMap
+{
+public:
+    using value_type = std::pair<std::string, VariableValue>;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+    VariableMap() = default;
+
+    VariableMap(std::initializer_list<value_type> entries)
+    {
+        reserve(entries.size());
+        for (auto const& [name, value] : entries)
+            insert(name, value);
+    }
+
+    const_iterator begin() const noexcept { return _entries.begin(); }
+    const_iterator end() const noexcept { return _entries.end(); }
+
+    size_t size() const noexcept { return _entries.size(); }
+    bool empty() const noexcept { return _entries.empty(); }
+
+    const_iterator find(std::string_view name) const noexcept
+    {
+        auto const bucket = find_bucket(name, hash_of(name));
+        return bucket == npos ? end() : begin() + static_cast<std::ptrdiff_t>(_buckets[bucket].index);
+    }
+
+    bool contains(std::string_view name) const noexcept { return find(name) != end(); }
+
+    VariableValue const& at(std::string_view name) const
+    {
+        auto const entry = find(name);
+        if (entry == end()) throw std::out_of_range("VariableMap::at");
+        return entry->second;
+    }
+
+    VariableValue& operator[](std::string_view name)
+    {
+        return _entries[emplace(name, {}).first].second;
+    }
+
+    // returns false, leaving the map untouched, when `name` was already present.
+    bool insert(std::string_view name, VariableValue value)
+    {
+        return emplace(name, std::move(value)).second;
+    }
+
+    // returns true when `name` wasn't present before.
+    bool insert_or_assign(std::string_view name, VariableValue value)
+    {
+        auto const [index, inserted] = emplace(name, {});
+        _entries[index].second = std::move(value);
+        return inserted;
+    }
+
+    bool erase(std::string_view name)
+    {
+        auto const hash = hash_of(name);
+        auto bucket = find_bucket(name, hash);
+        if (bucket == npos) return false;
+
+        auto const index = _buckets[bucket].index;
+
+        // backward shift deletion keeps every probe sequence contiguous without tombstones: an entry
+        // further down the cluster is moved into the hole unless its home bucket lies past the hole.
+        for (auto next = (bucket + 1) & mask(); _buckets[next].index != empty_g; next = (next + 1) & mask())
+        {
+            auto const home = _buckets[next].hash & mask();
+            if (((next - home) & mask()) < ((next - bucket) & mask())) continue;
+            _buckets[bucket] = _buckets[next];
+            bucket = next;
+        }
+
+        _buckets[bucket] = {};
+
+        // the last entry takes the erased entry's place, so its bucket has to follow it.
+        if (auto const last = _entries.size() - 1; index != last)
+        {
+            auto const lastBucket = find_bucket(_entries[last].first, hash_of(_entries[last].first));
+            _buckets[lastBucket].index = index;
+            _entries[index] = std::move(_entries[last]);
+        }
+
+        _entries.pop_back();
+
+        return true;
+    }
+
+    void reserve(size_t count)
+    {
+        _entries.reserve(count);
+
+        auto capacity = std::max<size_t>(_buckets.size(), 8);
+        while (count * 4 > capacity * 3) capacity *= 2;
+
+        if (capacity != _buckets.size()) rehash(capacity);
+    }
+
+    void clear() noexcept
+    {
+        _entries.clear();
+        std::ranges::fill(_buckets, Bucket {});
+    }
+
+private:
+    struct Bucket
+    {
+        size_t hash {};
+        uint32_t index { std::numeric_limits<uint32_t>::max() };
+    };
+
+    static constexpr uint32_t empty_g = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    static size_t hash_of(std::string_view name) noexcept { return std::hash<std::string_view> {}(name); }
+
+    size_t mask() const noexcept { return _buckets.size() - 1; }
+
+    size_t find_bucket(std::string_view name, size_t hash) const noexcept
+    {
+        if (_buckets.empty()) return npos;
+
+        for (auto bucket = hash & mask(); _buckets[bucket].index != empty_g; bucket = (bucket + 1) & mask())
+        {
+            if (_buckets[bucket].hash == hash && _entries[_buckets[bucket].index].first == name)
+                return bucket;
+        }
+
+        return npos;
+    }
+
+    std::pair<size_t, bool> emplace(std::string_view name, VariableValue value)
+    {
+        auto const hash = hash_of(name);
+
+        if (auto const bucket = find_bucket(name, hash); bucket != npos)
+            return { _buckets[bucket].index, false };
+
+        if ((_entries.size() + 1) * 4 > _buckets.size() * 3)
+            rehash(std::max<size_t>(_buckets.size() * 2, 8));
+
+        auto bucket = hash & mask();
+        while (_buckets[bucket].index != empty_g) bucket = (bucket + 1) & mask();
+
+        _buckets[bucket] = { hash, static_cast<uint32_t>(_entries.size()) };
+        _entries.emplace_back(std::string { name }, std::move(value));
+
+        return { _entries.size() - 1, true };
+    }
+
+    void rehash(size_t capacity)
+    {
+        _buckets.assign(capacity, Bucket {});
+
+        for (auto index = 0zu; index < _entries.size(); index += 1)
+        {
+            auto const hash = hash_of(_entries[index].first);
+            auto bucket = hash & mask();
+            while (_buckets[bucket].index != empty_g) bucket = (bucket + 1) & mask();
+            _buckets[bucket] = { hash, static_cast<uint32_t>(index) };
+        }
+    }
+
+    std::vector<value_type> _entries {};
+    std::vector<Bucket> _buckets {};
+};
+
+} // namespace libpreprocessor
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <concepts>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace libpreprocessor {
+
+// the value of a variable, an immutable string whose bytes are shared by every copy of it. copying a value, and with
+// it a context, only bumps a reference count, and since the bytes are never modified copies can be read from any
+// number of threads at once.
+class VariableValue
+{
+public:
+    VariableValue() = default;
+    VariableValue(std::string value) : _value { std::make_shared<std::string const>(std::move(value)) } {}
+    VariableValue(std::string_view value) : VariableValue { std::string { value } } {}
+    VariableValue(char const* value) : VariableValue { std::string { value } } {}
+
+    std::string const& str() const noexcept { return _value != nullptr ? *_value : empty_g; }
+    std::string_view view() const noexcept { return str(); }
+    operator std::string_view() const noexcept { return str(); }
+
+    // null-terminated, like `std::string::data`.
+    char const* data() const noexcept { return str().data(); }
+    size_t size() const noexcept { return str().size(); }
+    bool empty() const noexcept { return str().empty(); }
+
+    friend bool operator==(VariableValue const& lhs, VariableValue const& rhs) noexcept
+    {
+        return lhs._value == rhs._value || lhs.view() == rhs.view();
+    }
+
+    template <std::convertible_to<std::string_view> T>
+    friend bool operator==(VariableValue const& lhs, T const& rhs) noexcept
+    {
+        return lhs.view() == std::string_view { rhs };
+    }
+
+private:
+    static inline std::string const empty_g {};
+
+    std::shared_ptr<std::string const> _value {};
+};
+
+} // namespace libpreprocessor
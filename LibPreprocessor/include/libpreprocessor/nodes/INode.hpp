@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../Token.hpp"
+
 #include <memory>
 #include <list>
 
@@ -30,6 +32,8 @@ struct INode
     constexpr virtual char const* type_as_string() const = 0;
 
     std::list<std::unique_ptr<INode>> nodes {};
+    // where the token the node was parsed from is.
+    Token::Location location {};
 };
 
 constexpr bool is_statement(std::unique_ptr<INode> const& node) { return node->type() == INode::Type::STATEMENT; }
@@ -2,8 +2,12 @@
 
 #include "INode.hpp"
 #include "IStatementNode.hpp"
+#include "../Searcher.hpp"
 
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace libpreprocessor {
 
@@ -35,6 +39,8 @@ struct OperatorNode : INode
     Arity arity {};
     std::unique_ptr<INode> lhs {};
     std::unique_ptr<INode> rhs {};
+    // set by the compiler for CONTAINS when the right-hand side is a constant.
+    std::optional<Searcher> searcher {};
 
 private:
     using INode::nodes;
@@ -43,8 +49,29 @@ private:
 struct LiteralNode : INode
 {
     NODE_TYPE(INode::Type::LITERAL);
+
+    struct Segment
+    {
+        enum class Type
+        {
+            BEGIN__,
+            TEXT,
+            VARIABLE,
+            END__
+        };
+
+        std::string text {};
+        size_t slot {};
+        Type type {};
+    };
+
     virtual ~LiteralNode() override = default;
+
     std::string value {};
+    // filled by `compile`, a literal only parsed (not compiled) has no segments.
+    std::vector<Segment> segments {};
+    // filled by `compile` when the literal is a constant that decays to a boolean.
+    std::optional<bool> boolean {};
 
 private:
     using INode::nodes;
@@ -81,10 +108,18 @@ private:
     using INode::nodes;
 };
 
+struct SwitchCaseStatementNode;
+
 struct SwitchStatementNode : IStatementNode
 {
     STATEMENT_TYPE(IStatementNode::Type::SWITCH);
 
+    struct Case
+    {
+        size_t index;
+        SwitchCaseStatementNode const* node;
+    };
+
     virtual ~SwitchStatementNode() override = default;
 
     std::unique_ptr<INode> match {};
@@ -92,6 +127,11 @@ struct SwitchStatementNode : IStatementNode
         std::unique_ptr<INode>, std::unique_ptr<INode>
     > branches {};
 
+    // filled by `compile`: cases labeled by a constant literal are looked up by their label, while the
+    // ones whose label depends on the context are kept (in order) to be evaluated on every render.
+    std::optional<std::unordered_map<std::string, Case>> constantCases {};
+    std::vector<Case> dynamicCases {};
+
 private:
     using INode::nodes;
 };
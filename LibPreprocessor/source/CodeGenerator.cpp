@@ -0,0 +1,446 @@
+#include "CodeGenerator.hpp"
+
+#include "nodes/Nodes.hpp"
+
+#include <liberror/Try.hpp>
+#include <fmt/format.h>
+
+#include <algorithm>
+
+namespace libpreprocessor {
+
+using namespace liberror;
+using namespace std::literals;
+
+#define ERROR(fmt, ...) make_error(PREFIX_ERROR ": " fmt __VA_OPT__(,) __VA_ARGS__)
+
+namespace {
+
+struct GenerateState
+{
+    std::string code {};
+    size_t indentation {};
+    // content waiting to be appended, so consecutive contents end up in a single call.
+    std::string text {};
+    // numbers the temporaries declared by the generated code, so nested ones never shadow each other.
+    size_t temporaries {};
+};
+
+// an expression of the generated code, which is convertible to `std::string_view`.
+struct StringExpression
+{
+    std::string code {};
+    // evaluating it neither fails nor has any side effects, so it can be evaluated out of order.
+    bool pure {};
+};
+
+Result<StringExpression> generate_string(std::unique_ptr<INode> const& head, GenerateState& state);
+Result<std::string> generate_boolean(std::unique_ptr<INode> const& head, GenerateState& state);
+Result<void> generate_block(std::unique_ptr<INode> const& head, GenerateState& state);
+
+// a C++ string literal holding `string`, split after every newline so the generated code follows the template.
+std::string quote(std::string_view string)
+{
+    std::string result { "\"" };
+
+    for (auto index = 0zu; index < string.size(); index += 1)
+    {
+        auto const character = string[index];
+
+        switch (character)
+        {
+        case '"':  result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\t': result += "\\t"; break;
+        case '\r': result += "\\r"; break;
+        case '\n': {
+            result += "\\n";
+            if (index + 1 < string.size()) result += "\"\n\"";
+            break;
+        }
+        default: {
+            // octal escapes stop after three digits, unlike hexadecimal ones which would swallow a digit after them.
+            if (static_cast<unsigned char>(character) < 0x20 || static_cast<unsigned char>(character) >= 0x7f)
+                result += fmt::format("\\{:03o}", static_cast<unsigned char>(character));
+            else
+                result += character;
+            break;
+        }
+        }
+    }
+
+    return result + "\"";
+}
+
+void write_line(GenerateState& state, std::string_view line)
+{
+    state.code.append(state.indentation * 4, ' ');
+    state.code += line;
+    state.code += '\n';
+}
+
+void flush_text(GenerateState& state)
+{
+    if (state.text.empty()) return;
+
+    // the literal is indented by hand, since every line of it after the first is left where `quote` put it.
+    auto literal = quote(state.text);
+    for (auto position = literal.find('\n'); position != std::string::npos; position = literal.find('\n', position + 1))
+        literal.insert(position + 1, (state.indentation + 1) * 4, ' ');
+
+    write_line(state, fmt::format("output.append({}, {});", literal, state.text.size()));
+    state.text.clear();
+}
+
+INode const* innermost(std::unique_ptr<INode> const& head)
+{
+    auto const* node = head.get();
+
+    while (node != nullptr && node->type() == INode::Type::EXPRESSION)
+        node = static_cast<ExpressionNode const*>(node)->value.get();
+
+    return node;
+}
+
+StringExpression generate_literal(LiteralNode const* literalNode)
+{
+    using Segment = LiteralNode::Segment;
+
+    if (literalNode->segments.empty()) return { "TRY(libpreprocessor::GeneratedRender::empty_literal())", false };
+
+    auto const fnSegment = [] (Segment const& segment) {
+        return segment.type == Segment::Type::TEXT ? quote(segment.text) + "sv" : fmt::format("render.value({})", segment.slot);
+    };
+
+    if (literalNode->segments.size() == 1) return { fnSegment(literalNode->segments.front()), true };
+
+    std::string pieces {};
+
+    for (auto const& segment : literalNode->segments)
+    {
+        if (!pieces.empty()) pieces += ", ";
+        pieces += fnSegment(segment);
+    }
+
+    return { fmt::format("libpreprocessor::GeneratedRender::join({{ {} }})", pieces), true };
+}
+
+Result<std::string> generate_unary_operator(OperatorNode const* operatorNode, GenerateState& state)
+{
+    if (operatorNode->name == "NOT")
+    {
+        auto const* operand = innermost(operatorNode->lhs);
+
+        if (operand != nullptr && operand->type() == INode::Type::LITERAL)
+        {
+            if (auto const constant = static_cast<LiteralNode const*>(operand)->boolean) return *constant ? "false"s : "true"s;
+        }
+
+        if (operand != nullptr && operand->type() == INode::Type::OPERATOR)
+        {
+            return fmt::format("!{}", TRY(generate_boolean(operatorNode->lhs, state)));
+        }
+
+        return fmt::format("!TRY(libpreprocessor::internal::decay_to_boolean({}))", TRY(generate_string(operatorNode->lhs, state)).code);
+    }
+
+    return ERROR("Unknown unary operator \"{}\" was reached.", operatorNode->name);
+}
+
+Result<std::string> generate_binary_operator(OperatorNode const* operatorNode, GenerateState& state)
+{
+    if (operatorNode->rhs == nullptr)
+    {
+        return ERROR("Operator \"{}\" is a binary operator and expects both an left-hand and an right-hand side, but only the former was given.", operatorNode->name);
+    }
+
+    if (operatorNode->name == "AND" || operatorNode->name == "OR")
+    {
+        auto const lhs = TRY(generate_boolean(operatorNode->lhs, state));
+        auto const rhs = TRY(generate_boolean(operatorNode->rhs, state));
+        return fmt::format("({} {} {})", lhs, operatorNode->name == "AND" ? "&&" : "||", rhs);
+    }
+
+    if (operatorNode->name != "EQUALS" && operatorNode->name != "CONTAINS")
+    {
+        return ERROR("Unknown binary operator \"{}\" was reached.", operatorNode->name);
+    }
+
+    auto const lhs = TRY(generate_string(operatorNode->lhs, state));
+    auto const rhs = TRY(generate_string(operatorNode->rhs, state));
+
+    auto const fnCompare = [&operatorNode] (std::string_view left, std::string_view right) {
+        if (operatorNode->name == "EQUALS") return fmt::format("std::string_view {{ {} }} == {}", left, right);
+        return fmt::format("std::string_view {{ {} }}.contains({})", left, right);
+    };
+
+    if (rhs.pure) return fmt::format("({})", fnCompare(lhs.code, rhs.code));
+
+    // the left-hand side is evaluated first, the same as when interpreting. either side may fail, which returns
+    // from the lambda, so what it returns is tried once more.
+    auto const temporary = fmt::format("lhs{}", state.temporaries++);
+    return fmt::format("TRY(([&] () -> liberror::Result<bool> {{ auto const& {} = {}; return {}; }})())", temporary, lhs.code, fnCompare(temporary, rhs.code));
+}
+
+Result<std::string> generate_operator(OperatorNode const* operatorNode, GenerateState& state)
+{
+    if (operatorNode->lhs == nullptr) return ERROR("For any operator, it must have atleast one value for it to work on.");
+
+    switch (operatorNode->arity)
+    {
+    case OperatorNode::Arity::UNARY:  return generate_unary_operator(operatorNode, state);
+    case OperatorNode::Arity::BINARY: return generate_binary_operator(operatorNode, state);
+
+    case OperatorNode::Arity::BEGIN__: break;
+    case OperatorNode::Arity::END__: {
+        break;
+    }
+    }
+
+    return ERROR("Operator \"{}\" had an invalid arity.", operatorNode->name);
+}
+
+Result<StringExpression> generate_string(std::unique_ptr<INode> const& head, GenerateState& state)
+{
+    if (head == nullptr) return ERROR("Head node was nullptr.");
+
+    if (!is_expression(head))
+    {
+        return ERROR("Head node is expected to be of type \"INode::Type::EXPRESSION\", instead it was \"{}\".", head->type_as_string());
+    }
+
+    auto const& value = static_cast<ExpressionNode const*>(head.get())->value;
+
+    switch (value->type())
+    {
+    case INode::Type::OPERATOR: {
+        auto const condition = TRY(generate_operator(static_cast<OperatorNode const*>(value.get()), state));
+        return StringExpression { fmt::format("({} ? \"TRUE\"sv : \"FALSE\"sv)", condition), false };
+    }
+    case INode::Type::LITERAL:    return generate_literal(static_cast<LiteralNode const*>(value.get()));
+    case INode::Type::EXPRESSION: return generate_string(value, state);
+
+    case INode::Type::BEGIN__:
+    case INode::Type::END__:
+    default: {
+        return ERROR("Unexpected node of type \"{}\" was reached.", head->type_as_string());
+    }
+    }
+}
+
+// conditions and the operands of AND and OR are true only when they're exactly "TRUE", which an operator
+// already tells without going through its string.
+Result<std::string> generate_boolean(std::unique_ptr<INode> const& head, GenerateState& state)
+{
+    if (auto const* node = innermost(head); node != nullptr && node->type() == INode::Type::OPERATOR)
+    {
+        return generate_operator(static_cast<OperatorNode const*>(node), state);
+    }
+
+    return fmt::format("(std::string_view {{ {} }} == \"TRUE\"sv)", TRY(generate_string(head, state)).code);
+}
+
+Result<void> generate_branch(std::unique_ptr<INode> const& branch, GenerateState& state)
+{
+    write_line(state, "{");
+    state.indentation += 1;
+
+    if (branch != nullptr) TRY(generate_block(branch, state));
+    flush_text(state);
+
+    state.indentation -= 1;
+    write_line(state, "}");
+
+    return {};
+}
+
+Result<void> generate_switch_statement(SwitchStatementNode const* node, GenerateState& state)
+{
+    if (node->match == nullptr) return ERROR("\"%SWITCH\" statement match was nullptr.");
+
+    auto const match = fmt::format("match{}", state.temporaries++);
+
+    write_line(state, "{");
+    state.indentation += 1;
+    write_line(state, fmt::format("auto const& {} = {};", match, TRY(generate_string(node->match, state)).code));
+
+    // the first case whose label matches wins, whichever of them the compiler found to be constant.
+    auto keyword = "if"sv;
+
+    if (node->branches.first != nullptr)
+    {
+        for (auto const& subnode : node->branches.first->nodes)
+        {
+            auto const* caseNode = static_cast<SwitchCaseStatementNode const*>(subnode.get());
+
+            if (caseNode == nullptr) return ERROR("\"%CASE\" statement was nulllptr.");
+            if (caseNode->match == nullptr) return ERROR("\"%CASE\" statement match was nullptr.");
+
+            write_line(state, fmt::format("{} (std::string_view {{ {} }} == {})", keyword, match, TRY(generate_string(caseNode->match, state)).code));
+            TRY(generate_branch(caseNode->branch, state));
+            keyword = "else if";
+        }
+    }
+
+    auto const* defaultNode = static_cast<SwitchCaseStatementNode const*>(node->branches.second.get());
+
+    if (defaultNode != nullptr)
+    {
+        if (keyword != "if") write_line(state, "else");
+        TRY(generate_branch(defaultNode->branch, state));
+    }
+
+    state.indentation -= 1;
+    write_line(state, "}");
+
+    return {};
+}
+
+Result<void> generate_statement(IStatementNode const* node, GenerateState& state)
+{
+    flush_text(state);
+
+    switch (node->statement_type())
+    {
+    case IStatementNode::Type::IF: {
+        auto const* ifNode = static_cast<IfStatementNode const*>(node);
+
+        if (ifNode->condition == nullptr) return ERROR("\"%IF\" statement condition was nullptr.");
+
+        write_line(state, fmt::format("if ({})", TRY(generate_boolean(ifNode->condition, state))));
+        TRY(generate_branch(ifNode->branch.first, state));
+
+        if (ifNode->branch.second)
+        {
+            write_line(state, "else");
+            TRY(generate_branch(ifNode->branch.second, state));
+        }
+
+        return {};
+    }
+    case IStatementNode::Type::SWITCH: {
+        return generate_switch_statement(static_cast<SwitchStatementNode const*>(node), state);
+    }
+    case IStatementNode::Type::SWITCH_CASE: {
+        return generate_branch(static_cast<SwitchCaseStatementNode const*>(node)->branch, state);
+    }
+    case IStatementNode::Type::PRINT: {
+        auto const line = TRY(generate_string(static_cast<PrintStatementNode const*>(node)->content, state));
+        write_line(state, fmt::format("if (render.prints()) TRY(render.print(std::string {{ {} }}));", line.code));
+        return {};
+    }
+
+    case IStatementNode::Type::BEGIN__:
+    case IStatementNode::Type::END__:
+    default: {
+        break;
+    }
+    }
+
+    return ERROR("Unexpected statement node of type \"{}\" was reached.", node->type_as_string());
+}
+
+Result<void> generate_node(std::unique_ptr<INode> const& head, GenerateState& state)
+{
+    switch (head->type())
+    {
+    case INode::Type::STATEMENT: {
+        TRY(generate_statement(static_cast<IStatementNode const*>(head.get()), state));
+        break;
+    }
+    case INode::Type::CONTENT: {
+        // the same newline the interpreter adds, decided once here.
+        auto const& content = static_cast<ContentNode const*>(head.get())->content;
+        state.text += content;
+        if (!(!content.empty() && content.front() == '\n' && content.back() == '\n')) state.text += '\n';
+        break;
+    }
+    case INode::Type::SCOPE: {
+        break;
+    }
+
+    case INode::Type::EXPRESSION:
+    case INode::Type::CONDITION:
+    case INode::Type::OPERATOR:
+    case INode::Type::LITERAL:
+
+    case INode::Type::BEGIN__:
+    case INode::Type::END__:
+    default: {
+        return ERROR("Unexpected node of type \"{}\" was reached.", head->type_as_string());
+    }
+    }
+
+    return {};
+}
+
+Result<void> generate_block(std::unique_ptr<INode> const& head, GenerateState& state)
+{
+    if (head == nullptr) return ERROR("Head node was nullptr.");
+
+    TRY(generate_node(head, state));
+
+    for (auto const& subnode : head->nodes)
+    {
+        TRY(generate_block(subnode, state));
+    }
+
+    return {};
+}
+
+}
+
+Result<std::string> generate_cpp(Template const& compiled, CodeGeneratorOptions const& options)
+{
+    GenerateState state {};
+    state.indentation = 1;
+
+    if (compiled.head != nullptr) TRY(generate_block(compiled.head, state));
+    flush_text(state);
+
+    auto const body = std::move(state.code);
+
+    std::string names {};
+
+    for (auto const& name : compiled.symbols.names())
+    {
+        if (!names.empty()) names += ", ";
+        names += quote(name) + "sv";
+    }
+
+    std::string result {};
+
+    result += fmt::format("// generated by libpreprocessor{}, any change made to it is lost once it's generated again.\n\n",
+                          options.source.empty() ? "" : fmt::format(" from \"{}\"", options.source));
+    result += "#pragma once\n\n";
+    result += "#include <libpreprocessor/Interpreter.hpp>\n\n";
+    result += "#include <liberror/Result.hpp>\n";
+    result += "#include <liberror/Try.hpp>\n\n";
+    result += "#include <array>\n#include <string>\n#include <string_view>\n\n";
+
+    if (!options.namespaceName.empty()) result += fmt::format("namespace {} {{\n\n", options.namespaceName);
+
+    result += fmt::format("inline liberror::Result<void> {}(libpreprocessor::PreprocessorContext const& context, std::string& output)\n", options.functionName);
+    result += "{\n";
+    result += "    using namespace std::literals;\n\n";
+    result += fmt::format("    static constexpr std::array<std::string_view, {}> names {{ {} }};\n", compiled.symbols.size(), names);
+    result += "    TRY(libpreprocessor::GeneratedRender::check_sink(context.print));\n";
+    result += "    libpreprocessor::GeneratedRender render { context, names };\n\n";
+    result += fmt::format("    output.reserve(output.size() + {});\n\n", compiled.contentBytes);
+    result += body;
+    result += "\n    return {};\n";
+    result += "}\n\n";
+
+    result += fmt::format("inline liberror::Result<std::string> {}(libpreprocessor::PreprocessorContext const& context)\n", options.functionName);
+    result += "{\n";
+    result += "    std::string output {};\n";
+    result += fmt::format("    TRY({}(context, output));\n", options.functionName);
+    result += "    return output;\n";
+    result += "}\n";
+
+    if (!options.namespaceName.empty()) result += fmt::format("\n}} // namespace {}\n", options.namespaceName);
+
+    return result;
+}
+
+} // namespace libpreprocessor
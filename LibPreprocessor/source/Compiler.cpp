@@ -0,0 +1,328 @@
+#include "Compiler.hpp"
+
+#include "Interpreter.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "nodes/Nodes.hpp"
+
+#include <liberror/Try.hpp>
+
+#include <atomic>
+#include <chrono>
+
+namespace libpreprocessor {
+
+using namespace liberror;
+
+#define ERROR(fmt, ...) make_error(PREFIX_ERROR ": " fmt __VA_OPT__(,) __VA_ARGS__)
+
+size_t SymbolTable::intern(std::string_view name)
+{
+    if (auto const slot = find(name)) return *slot;
+    _slots.emplace(std::string { name }, _names.size());
+    _names.emplace_back(name);
+    return _names.size() - 1;
+}
+
+std::optional<size_t> SymbolTable::find(std::string_view name) const
+{
+    auto const slot = _slots.find(name);
+    if (slot == _slots.end()) return std::nullopt;
+    return slot->second;
+}
+
+namespace {
+
+std::atomic<uint64_t> nextTemplateId_g { 1 };
+
+struct CompileState
+{
+    SymbolTable& symbols;
+    bool prints {};
+    size_t contentBytes {};
+    Statistics* statistics {};
+};
+
+Result<void> compile_node(std::unique_ptr<INode> const& head, CompileState& state);
+
+void compile_literal(LiteralNode* literalNode, CompileState& state)
+{
+    using Segment = LiteralNode::Segment;
+
+    literalNode->segments.clear();
+    literalNode->boolean.reset();
+
+    // an empty literal is left without segments, so the interpreter keeps reporting it when it's reached.
+    std::string_view const value = literalNode->value;
+    if (value.empty()) return;
+
+    for (auto index = 0zu; index < value.size();)
+    {
+        auto const begin = value.find('|', index);
+        auto const end = begin == std::string_view::npos ? begin : value.find('|', begin + 1);
+
+        if (end == std::string_view::npos)
+        {
+            literalNode->segments.push_back({ std::string { value.substr(index) }, 0, Segment::Type::TEXT });
+            break;
+        }
+
+        if (begin > index)
+        {
+            literalNode->segments.push_back({ std::string { value.substr(index, begin - index) }, 0, Segment::Type::TEXT });
+        }
+
+        auto const name = value.substr(begin + 1, end - begin - 1);
+        literalNode->segments.push_back({ std::string { name }, state.symbols.intern(name), Segment::Type::VARIABLE });
+
+        index = end + 1;
+    }
+
+    // a constant that can't be decayed is left alone, so the interpreter reports it only if it's ever decayed.
+    if (literalNode->segments.size() == 1 && literalNode->segments.front().type == Segment::Type::TEXT)
+    {
+        if (auto const boolean = internal::decay_to_boolean(literalNode->segments.front().text); boolean.has_value())
+            literalNode->boolean = boolean.value();
+    }
+}
+
+std::optional<std::string> constant_label(std::unique_ptr<INode> const& match)
+{
+    auto const* node = match.get();
+
+    // a label may be wrapped in any number of expressions, as in `[[<label>]]`.
+    while (node != nullptr && node->type() == INode::Type::EXPRESSION)
+        node = static_cast<ExpressionNode const*>(node)->value.get();
+
+    if (node == nullptr || node->type() != INode::Type::LITERAL) return std::nullopt;
+
+    auto const* literalNode = static_cast<LiteralNode const*>(node);
+    if (literalNode->segments.empty()) return std::nullopt;
+
+    std::string label {};
+
+    for (auto const& segment : literalNode->segments)
+    {
+        if (segment.type != LiteralNode::Segment::Type::TEXT) return std::nullopt;
+        label += segment.text;
+    }
+
+    return label;
+}
+
+Result<void> compile_switch_cases(SwitchStatementNode* switchNode)
+{
+    switchNode->constantCases.emplace();
+    switchNode->dynamicCases.clear();
+
+    if (switchNode->branches.first == nullptr) return {};
+
+    auto index = 0zu;
+
+    for (auto const& subnode : switchNode->branches.first->nodes)
+    {
+        if (!is_statement(subnode) || static_cast<IStatementNode const*>(subnode.get())->statement_type() != IStatementNode::Type::SWITCH_CASE)
+            return ERROR("\"%SWITCH\" statement expects only \"%CASE\" statements, instead got \"{}\".", subnode->type_as_string());
+
+        auto const* caseNode = static_cast<SwitchCaseStatementNode const*>(subnode.get());
+
+        if (auto label = constant_label(caseNode->match))
+            switchNode->constantCases->try_emplace(std::move(*label), SwitchStatementNode::Case { index, caseNode });
+        else
+            switchNode->dynamicCases.push_back({ index, caseNode });
+
+        index += 1;
+    }
+
+    return {};
+}
+
+Result<void> compile_statement(IStatementNode* statementNode, CompileState& state)
+{
+    switch (statementNode->statement_type())
+    {
+    case IStatementNode::Type::IF: {
+        auto* node = static_cast<IfStatementNode*>(statementNode);
+        TRY(compile_node(node->condition, state));
+        TRY(compile_node(node->branch.first, state));
+        TRY(compile_node(node->branch.second, state));
+        break;
+    }
+    case IStatementNode::Type::SWITCH: {
+        auto* node = static_cast<SwitchStatementNode*>(statementNode);
+        TRY(compile_node(node->match, state));
+        TRY(compile_node(node->branches.first, state));
+        TRY(compile_node(node->branches.second, state));
+        TRY(compile_switch_cases(node));
+        break;
+    }
+    case IStatementNode::Type::SWITCH_CASE: {
+        auto* node = static_cast<SwitchCaseStatementNode*>(statementNode);
+        TRY(compile_node(node->match, state));
+        TRY(compile_node(node->branch, state));
+        break;
+    }
+    case IStatementNode::Type::PRINT: {
+        auto* node = static_cast<PrintStatementNode*>(statementNode);
+        TRY(compile_node(node->content, state));
+        state.prints = true;
+        break;
+    }
+
+    case IStatementNode::Type::BEGIN__:
+    case IStatementNode::Type::END__:
+    default: {
+        return ERROR("Unexpected statement node of type \"{}\" was reached.", statementNode->statement_type_as_string());
+    }
+    }
+
+    return {};
+}
+
+Result<void> compile_node(std::unique_ptr<INode> const& head, CompileState& state)
+{
+    if (head == nullptr) return {};
+
+    if (state.statistics != nullptr) state.statistics->nodes[static_cast<size_t>(head->type())] += 1;
+
+    switch (head->type())
+    {
+    case INode::Type::STATEMENT: {
+        TRY(compile_statement(static_cast<IStatementNode*>(head.get()), state));
+        break;
+    }
+    case INode::Type::EXPRESSION: {
+        TRY(compile_node(static_cast<ExpressionNode*>(head.get())->value, state));
+        break;
+    }
+    case INode::Type::OPERATOR: {
+        auto* operatorNode = static_cast<OperatorNode*>(head.get());
+        TRY(compile_node(operatorNode->lhs, state));
+        TRY(compile_node(operatorNode->rhs, state));
+
+        operatorNode->searcher.reset();
+        if (operatorNode->name == "CONTAINS")
+        {
+            if (auto needle = constant_label(operatorNode->rhs)) operatorNode->searcher.emplace(std::move(*needle));
+        }
+        break;
+    }
+    case INode::Type::LITERAL: {
+        compile_literal(static_cast<LiteralNode*>(head.get()), state);
+        break;
+    }
+    case INode::Type::CONTENT: {
+        auto const& content = static_cast<ContentNode const*>(head.get())->content;
+        // mirrors the interpreter, which adds a newline unless the content both starts and ends with one.
+        auto const newline = !content.empty() && content.front() == '\n' && content.back() == '\n';
+        state.contentBytes += content.size() + (newline ? 0 : 1);
+        break;
+    }
+    case INode::Type::SCOPE: {
+        break;
+    }
+
+    case INode::Type::CONDITION:
+
+    case INode::Type::BEGIN__:
+    case INode::Type::END__:
+    default: {
+        return ERROR("Unexpected node of type \"{}\" was reached.", head->type_as_string());
+    }
+    }
+
+    for (auto const& subnode : head->nodes)
+    {
+        TRY(compile_node(subnode, state));
+    }
+
+    return {};
+}
+
+Result<Template> compile_template(std::unique_ptr<INode> head, Statistics* statistics)
+{
+    Template result {};
+    result.head = std::move(head);
+
+    CompileState state { result.symbols, false, 0, statistics };
+    TRY(compile_node(result.head, state));
+
+    result.id = nextTemplateId_g.fetch_add(1, std::memory_order_relaxed);
+    result.prints = state.prints;
+    result.contentBytes = state.contentBytes;
+
+    return result;
+}
+
+// `source` is either the template itself, the path to it or both, the lexer takes care of all of them.
+template <typename... Source>
+Result<Template> compile_source(Statistics* statistics, Source const&... source)
+{
+    using Clock = std::chrono::steady_clock;
+
+    if (statistics != nullptr) *statistics = {};
+
+    auto begin = statistics != nullptr ? Clock::now() : Clock::time_point {};
+
+    auto const fnMeasure = [&] (std::chrono::nanoseconds Statistics::* phase) {
+        if (statistics == nullptr) return;
+        auto const end = Clock::now();
+        statistics->*phase = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin);
+        begin = end;
+    };
+
+    Lexer lexer { source... };
+    auto const tokens = lexer.tokenize();
+    fnMeasure(&Statistics::lexing);
+
+    Parser parser { tokens };
+    auto head = TRY(parser.parse());
+    fnMeasure(&Statistics::parsing);
+
+    auto result = TRY(compile_template(std::move(head), statistics));
+    fnMeasure(&Statistics::compiling);
+
+    if (statistics != nullptr) statistics->tokens = tokens.size();
+
+    return result;
+}
+
+}
+
+Result<void> compile(std::unique_ptr<INode> const& head, SymbolTable& symbols)
+{
+    CompileState state { symbols };
+    return compile_node(head, state);
+}
+
+Result<Template> compile(std::unique_ptr<INode> head)
+{
+    return compile_template(std::move(head), nullptr);
+}
+
+Result<Template> compile(std::string_view source)
+{
+    return compile_source(nullptr, source);
+}
+
+Result<Template> compile(std::filesystem::path path)
+{
+    return compile_source(nullptr, path);
+}
+
+Result<Template> compile(std::filesystem::path path, std::string_view source)
+{
+    return compile_source(nullptr, path, source);
+}
+
+Result<Template> compile(std::string_view source, Statistics& statistics)
+{
+    return compile_source(&statistics, source);
+}
+
+Result<Template> compile(std::filesystem::path path, Statistics& statistics)
+{
+    return compile_source(&statistics, path);
+}
+
+} // namespace libpreprocessor
@@ -4,8 +4,15 @@
 
 #include <liberror/Try.hpp>
 #include <fmt/format.h>
+#include <fmt/ranges.h>
 
-#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <list>
+#include <thread>
+#include <utility>
 
 namespace libpreprocessor {
 
@@ -16,48 +23,112 @@ using namespace std::literals;
 
 namespace internal {
 
-static Result<size_t> decay_to_integer(std::string_view literal);
-static Result<bool> decay_to_boolean(std::string_view literal);
-static Result<std::string> interpolate(std::string_view string, PreprocessorContext const& context);
+static Result<std::string> interpolate(std::string_view string, PreprocessorContext const& context, ProvidedValues* provided);
 
 } // namespace internal
 
 namespace detail {
 
-static Result<void> traverse(std::unique_ptr<INode> const& head, std::stringstream& stream, PreprocessorContext const& context);
+// what a render measured into `Statistics` adds up as it goes, since its buffers keep growing until it's over.
+struct RenderMeasure
+{
+    Statistics& statistics;
+    size_t outputBytes {};
+    // what the bound values, the provided values and the printed lines take.
+    size_t heldBytes {};
+
+    void grow(size_t bytes) noexcept
+    {
+        heldBytes += bytes;
+        statistics.peakScratchBytes = std::max(statistics.peakScratchBytes, outputBytes + heldBytes);
+    }
+};
+
+struct RenderState
+{
+    PreprocessorContext const& context;
+    // both are only set when rendering a compiled template, holding the value bound to each symbol slot.
+    SymbolTable const* symbols {};
+    std::span<std::string_view> values {};
+    // what the context's provider answered so far in this render.
+    ProvidedValues* provided {};
+    // %PRINT lines gathered for the STDOUT and BUFFER sinks.
+    std::vector<std::string>* printed {};
+    // when set, every slot whose value is read gets marked.
+    std::vector<bool>* reads {};
+    Profiler* profiler {};
+    RenderMeasure* measure {};
+};
+
+static Result<void> traverse(std::unique_ptr<INode> const& head, std::string& output, RenderState const& state);
+
+// the value of a variable the context doesn't hold, asking its provider only the first time a render needs it.
+static std::optional<std::string_view> provide(std::string_view name, PreprocessorContext const& context, ProvidedValues& provided)
+{
+    if (!context.provider) return std::nullopt;
+
+    auto entry = provided.find(name);
+    if (entry == provided.end()) entry = provided.emplace(std::string { name }, context.provider(name)).first;
+
+    if (!entry->second.has_value()) return std::nullopt;
+    return std::string_view { *entry->second };
+}
 
 namespace {
 
-Result<std::string> evaluate(std::unique_ptr<INode> const& head, PreprocessorContext const& context);
+Result<std::string> evaluate(std::unique_ptr<INode> const& head, RenderState const& state);
 
-Result<std::string> evaluate_unary_operator(OperatorNode const* operatorNode, PreprocessorContext const& context)
+// the boolean a constant literal decayed to when it was compiled, looking through any expressions wrapping it.
+std::optional<bool> constant_boolean(std::unique_ptr<INode> const& head)
 {
-    auto const lhs = TRY(evaluate(operatorNode->lhs, context));
+    auto const* node = head.get();
+
+    while (node != nullptr && node->type() == INode::Type::EXPRESSION)
+        node = static_cast<ExpressionNode const*>(node)->value.get();
 
-    if (operatorNode->name == "NOT") return TRY(internal::decay_to_boolean(lhs)) ? "FALSE"s : "TRUE"s;
+    if (node == nullptr || node->type() != INode::Type::LITERAL) return std::nullopt;
+
+    return static_cast<LiteralNode const*>(node)->boolean;
+}
+
+Result<std::string> evaluate_unary_operator(OperatorNode const* operatorNode, RenderState const& state)
+{
+    if (operatorNode->name == "NOT")
+    {
+        if (auto const constant = constant_boolean(operatorNode->lhs)) return *constant ? "FALSE"s : "TRUE"s;
+        return TRY(internal::decay_to_boolean(TRY(evaluate(operatorNode->lhs, state)))) ? "FALSE"s : "TRUE"s;
+    }
 
     return ERROR("Unknown unary operator \"{}\" was reached.", operatorNode->name);
 }
 
-Result<std::string> evaluate_binary_operator(OperatorNode const* operatorNode, PreprocessorContext const& context)
+Result<std::string> evaluate_binary_operator(OperatorNode const* operatorNode, RenderState const& state)
 {
     if (operatorNode->rhs == nullptr)
     {
         return ERROR("Operator \"{}\" is a binary operator and expects both an left-hand and an right-hand side, but only the former was given.", operatorNode->name);
     }
 
-    auto const lhs = TRY(evaluate(operatorNode->lhs, context));
-    auto const rhs = TRY(evaluate(operatorNode->rhs, context));
+    auto const lhs = TRY(evaluate(operatorNode->lhs, state));
+
+    // the right-hand side of AND/OR is only evaluated when the left-hand side didn't already decide the result.
+    if (operatorNode->name == "AND" && lhs != "TRUE") return "FALSE"s;
+    if (operatorNode->name == "OR" && lhs == "TRUE") return "TRUE"s;
+
+    // a constant needle was already turned into a searcher, so there's nothing left to evaluate on the right.
+    if (operatorNode->searcher.has_value()) return operatorNode->searcher->found_in(lhs) ? "TRUE"s : "FALSE"s;
 
-    if (operatorNode->name == "CONTAINS") return lhs.contains(rhs)              ? "TRUE"s : "FALSE"s;
-    if (operatorNode->name == "EQUALS")   return lhs == rhs                     ? "TRUE"s : "FALSE"s;
-    if (operatorNode->name == "AND")      return lhs == "TRUE" && rhs == "TRUE" ? "TRUE"s : "FALSE"s;
-    if (operatorNode->name == "OR")       return lhs == "TRUE" || rhs == "TRUE" ? "TRUE"s : "FALSE"s;
+    auto const rhs = TRY(evaluate(operatorNode->rhs, state));
+
+    if (operatorNode->name == "CONTAINS") return lhs.contains(rhs) ? "TRUE"s : "FALSE"s;
+    if (operatorNode->name == "EQUALS")   return lhs == rhs        ? "TRUE"s : "FALSE"s;
+    if (operatorNode->name == "AND")      return rhs == "TRUE"     ? "TRUE"s : "FALSE"s;
+    if (operatorNode->name == "OR")       return rhs == "TRUE"     ? "TRUE"s : "FALSE"s;
 
     return ERROR("Unknown binary operator \"{}\" was reached.", operatorNode->name);
 }
 
-Result<std::string> evaluate_operator(ExpressionNode const* expressionNode, PreprocessorContext const& context)
+Result<std::string> evaluate_operator(ExpressionNode const* expressionNode, RenderState const& state)
 {
     auto* operatorNode = static_cast<OperatorNode*>(expressionNode->value.get());
 
@@ -66,8 +137,8 @@ Result<std::string> evaluate_operator(ExpressionNode const* expressionNode, Prep
 
     switch (operatorNode->arity)
     {
-    case OperatorNode::Arity::UNARY:  return evaluate_unary_operator(operatorNode, context);
-    case OperatorNode::Arity::BINARY: return evaluate_binary_operator(operatorNode, context);
+    case OperatorNode::Arity::UNARY:  return evaluate_unary_operator(operatorNode, state);
+    case OperatorNode::Arity::BINARY: return evaluate_binary_operator(operatorNode, state);
 
     case OperatorNode::Arity::BEGIN__: break;
     case OperatorNode::Arity::END__: {
@@ -78,14 +149,58 @@ Result<std::string> evaluate_operator(ExpressionNode const* expressionNode, Prep
     return ERROR("Operator \"{}\" had an invalid arity.", operatorNode->name);
 }
 
-Result<std::string> evaluate_literal(ExpressionNode const* expressionNode, PreprocessorContext const& context)
+std::string_view read_value(size_t slot, RenderState const& state)
+{
+    if (state.reads != nullptr) (*state.reads)[slot] = true;
+
+    if (state.measure != nullptr) state.measure->statistics.variableLookups += 1;
+
+    auto& value = state.values[slot];
+    if (value.data() == nullptr)
+    {
+        auto const& name = state.symbols->names()[slot];
+        auto const provided = state.provided->size();
+        value = provide(name, state.context, *state.provided).value_or(name);
+
+        if (state.measure != nullptr && state.provided->size() != provided)
+        {
+            auto const& [key, answer] = *state.provided->find(name);
+            state.measure->grow(sizeof(ProvidedValues::value_type) + key.capacity() + (answer.has_value() ? answer->capacity() : 0));
+        }
+    }
+
+    return value;
+}
+
+Result<std::string> evaluate_literal(ExpressionNode const* expressionNode, RenderState const& state)
 {
     auto const* literalNode = static_cast<LiteralNode const*>(expressionNode->value.get());
     if (literalNode == nullptr) return ERROR("literalNode was nullptr.");
-    return internal::interpolate(literalNode->value, context);
+
+    if (literalNode->segments.empty() || state.symbols == nullptr)
+    {
+        return internal::interpolate(literalNode->value, state.context, state.provided);
+    }
+
+    if (literalNode->segments.size() == 1)
+    {
+        auto const& segment = literalNode->segments.front();
+        if (segment.type == LiteralNode::Segment::Type::TEXT) return segment.text;
+        return std::string { read_value(segment.slot, state) };
+    }
+
+    std::string result {};
+
+    for (auto const& segment : literalNode->segments)
+    {
+        if (segment.type == LiteralNode::Segment::Type::TEXT) result += segment.text;
+        else                                                  result += read_value(segment.slot, state);
+    }
+
+    return result;
 }
 
-Result<std::string> evaluate(std::unique_ptr<INode> const& head, PreprocessorContext const& context)
+Result<std::string> evaluate(std::unique_ptr<INode> const& head, RenderState const& state)
 {
     if (head == nullptr) return ERROR("Head node was nullptr.");
 
@@ -96,11 +211,14 @@ Result<std::string> evaluate(std::unique_ptr<INode> const& head, PreprocessorCon
 
     auto const* expressionNode = static_cast<ExpressionNode const*>(head.get());
 
+    // attributed to what the expression holds, so operators and interpolated literals show up on their own.
+    Profiler::Scope const scope { state.profiler, expressionNode->value.get() };
+
     switch (expressionNode->value->type())
     {
-    case INode::Type::OPERATOR:   return evaluate_operator(expressionNode, context);
-    case INode::Type::LITERAL:    return evaluate_literal(expressionNode, context);
-    case INode::Type::EXPRESSION: return evaluate(expressionNode->value, context);
+    case INode::Type::OPERATOR:   return evaluate_operator(expressionNode, state);
+    case INode::Type::LITERAL:    return evaluate_literal(expressionNode, state);
+    case INode::Type::EXPRESSION: return evaluate(expressionNode->value, state);
 
     case INode::Type::BEGIN__:
     case INode::Type::END__:
@@ -112,34 +230,30 @@ Result<std::string> evaluate(std::unique_ptr<INode> const& head, PreprocessorCon
     return "FALSE"s;
 }
 
-Result<void> traverse_if_statement(IStatementNode const* statementNode, std::stringstream& stream, PreprocessorContext const& context)
+Result<SwitchCaseStatementNode const*> select_switch_case(SwitchStatementNode const* node, RenderState const& state)
 {
-    auto const* node = static_cast<IfStatementNode const*>(statementNode);
+    if (node->match == nullptr) return ERROR("\"%SWITCH\" statement match was nullptr.");
 
-    if (node->condition == nullptr) return ERROR("\"%IF\" statement condition was nullptr.");
+    auto const match = TRY(evaluate(node->match, state));
 
-    if (TRY(evaluate(node->condition, context)) == "TRUE") return traverse(node->branch.first, stream, context);
-    if (node->branch.second) return traverse(node->branch.second, stream, context);
+    if (node->constantCases.has_value())
+    {
+        SwitchStatementNode::Case const* selected = nullptr;
 
-    return {};
-}
+        if (auto const constantCase = node->constantCases->find(match); constantCase != node->constantCases->end())
+            selected = &constantCase->second;
 
-Result<void> traverse_switch_statement(IStatementNode const* statementNode, std::stringstream& stream, PreprocessorContext const& context)
-{
-    if (statementNode->statement_type() == IStatementNode::Type::SWITCH_CASE)
-    {
-        auto const* node = static_cast<SwitchCaseStatementNode const*>(statementNode);
-        TRY(traverse(node->branch, stream, context));
+        // a case whose label depends on the context only wins when it comes before the matching constant one.
+        for (auto const& dynamicCase : node->dynamicCases)
+        {
+            if (selected != nullptr && dynamicCase.index > selected->index) break;
+            if (TRY(evaluate(dynamicCase.node->match, state)) == match) return dynamicCase.node;
+        }
+
+        if (selected != nullptr) return selected->node;
     }
     else
     {
-        auto const* node = static_cast<SwitchStatementNode const*>(statementNode);
-
-        if (node->match == nullptr) return ERROR("\"%SWITCH\" statement match was nullptr.");
-
-        auto const match = TRY(evaluate(node->match, context));
-        bool hasHandledNormalCase = false;
-
         for (auto const& subnode : node->branches.first->nodes)
         {
             auto const* innerNode = static_cast<SwitchCaseStatementNode const*>(subnode.get());
@@ -147,69 +261,102 @@ Result<void> traverse_switch_statement(IStatementNode const* statementNode, std:
             if (innerNode == nullptr) return ERROR("\"%CASE\" statement was nulllptr.");
             if (innerNode->match == nullptr) return ERROR("\"%CASE\" statement match was nullptr.");
 
-            if (TRY(evaluate(innerNode->match, context)) == match)
-            {
-                TRY(traverse(subnode, stream, context));
-                hasHandledNormalCase = true;
-                break;
-            }
-        }
-
-        if (!hasHandledNormalCase && node->branches.second)
-        {
-            auto const* innerNode = static_cast<SwitchCaseStatementNode const*>(node->branches.second.get());
-            TRY(traverse(innerNode->branch, stream, context));
+            if (TRY(evaluate(innerNode->match, state)) == match) return innerNode;
         }
     }
 
-    return {};
+    return static_cast<SwitchCaseStatementNode const*>(node->branches.second.get());
 }
 
-Result<void> traverse_print_statement(IStatementNode const* statementNode, PreprocessorContext const& context)
+Result<void> traverse_print_statement(IStatementNode const* statementNode, RenderState const& state)
 {
     auto const* node = static_cast<PrintStatementNode const*>(statementNode);
-    fmt::println("{}", TRY(evaluate(node->content, context)));
-    return {};
-}
-
-Result<void> traverse_statement(std::unique_ptr<INode> const& head, std::stringstream& stream, PreprocessorContext const& context)
-{
-    if (head == nullptr) return ERROR("Head node was nullptr.");
+    auto const& sink = state.context.print;
 
-    if (!is_statement(head))
+    switch (sink.type)
     {
-        return ERROR("Head node is expected to be of type \"INode::Type::STATEMENT\", instead it was \"{}\".", head->type_as_string());
+    case PrintSink::Type::STDOUT:
+    case PrintSink::Type::BUFFER: {
+        state.printed->push_back(TRY(evaluate(node->content, state)));
+        if (state.measure != nullptr) state.measure->grow(state.printed->back().capacity());
+        return {};
+    }
+    case PrintSink::Type::DISCARD: {
+        return {};
+    }
+    case PrintSink::Type::CALLBACK: {
+        auto const line = TRY(evaluate(node->content, state));
+        if (sink.callback) sink.callback(line);
+        return {};
     }
 
-    auto const* node = static_cast<IStatementNode const*>(head.get());
+    case PrintSink::Type::BEGIN__:
+    case PrintSink::Type::END__:
+    default: {
+        break;
+    }
+    }
+
+    return ERROR("\"%PRINT\" statement had an invalid sink.");
+}
 
+// the branch a statement goes on to render, or nullptr when it doesn't render anything.
+Result<std::unique_ptr<INode> const*> select_branch(IStatementNode const* node, RenderState const& state)
+{
     switch (node->statement_type())
     {
     case IStatementNode::Type::IF: {
-        TRY(traverse_if_statement(node, stream, context));
-        break;
+        auto const* ifNode = static_cast<IfStatementNode const*>(node);
+
+        if (ifNode->condition == nullptr) return ERROR("\"%IF\" statement condition was nullptr.");
+
+        if (TRY(evaluate(ifNode->condition, state)) == "TRUE") return &ifNode->branch.first;
+        if (ifNode->branch.second) return &ifNode->branch.second;
+
+        return nullptr;
+    }
+    case IStatementNode::Type::SWITCH: {
+        if (auto const* caseNode = TRY(select_switch_case(static_cast<SwitchStatementNode const*>(node), state)))
+            return &caseNode->branch;
+
+        return nullptr;
     }
-    case IStatementNode::Type::SWITCH:
     case IStatementNode::Type::SWITCH_CASE: {
-        TRY(traverse_switch_statement(node, stream, context));
-        break;
+        return &static_cast<SwitchCaseStatementNode const*>(node)->branch;
     }
     case IStatementNode::Type::PRINT: {
-        TRY(traverse_print_statement(node, context));
-        break;
+        TRY(traverse_print_statement(node, state));
+        return nullptr;
     }
 
     case IStatementNode::Type::BEGIN__:
     case IStatementNode::Type::END__:
     default: {
-        return ERROR("Unexpected statement node of type \"{}\" was reached.", node->type_as_string());
+        break;
     }
     }
 
+    return ERROR("Unexpected statement node of type \"{}\" was reached.", node->type_as_string());
+}
+
+Result<void> traverse_statement(std::unique_ptr<INode> const& head, std::string& output, RenderState const& state)
+{
+    if (head == nullptr) return ERROR("Head node was nullptr.");
+
+    if (!is_statement(head))
+    {
+        return ERROR("Head node is expected to be of type \"INode::Type::STATEMENT\", instead it was \"{}\".", head->type_as_string());
+    }
+
+    if (auto const* branch = TRY(select_branch(static_cast<IStatementNode const*>(head.get()), state)))
+    {
+        TRY(traverse(*branch, output, state));
+    }
+
     return {};
 }
 
-Result<void> traverse_content(std::unique_ptr<INode> const& head, std::stringstream& stream)
+Result<void> traverse_content(std::unique_ptr<INode> const& head, std::string& output)
 {
     if (head == nullptr) return ERROR("Head node was nullptr.");
 
@@ -219,11 +366,11 @@ Result<void> traverse_content(std::unique_ptr<INode> const& head, std::stringstr
     }
 
     auto const* contentNode = static_cast<ContentNode const*>(head.get());
-    stream << contentNode->content;
+    output += contentNode->content;
 
     if (!((contentNode->content.front() == contentNode->content.back()) && contentNode->content.front() == '\n'))
     {
-        stream << '\n';
+        output += '\n';
     }
 
     return {};
@@ -231,18 +378,28 @@ Result<void> traverse_content(std::unique_ptr<INode> const& head, std::stringstr
 
 }
 
-static Result<void> traverse(std::unique_ptr<INode> const& head, std::stringstream& stream, PreprocessorContext const& context)
+// renders `head` alone, leaving out the nodes that follow it.
+static Result<void> traverse_node(std::unique_ptr<INode> const& head, std::string& output, RenderState const& state)
 {
     if (head == nullptr) return ERROR("Head node was nullptr.");
 
+    Profiler::Scope const scope { state.profiler, head.get() };
+
     switch (head->type())
     {
     case INode::Type::STATEMENT: {
-        TRY(traverse_statement(head, stream, context));
+        TRY(traverse_statement(head, output, state));
         break;
     }
     case INode::Type::CONTENT: {
-        TRY(traverse_content(head, stream));
+        TRY(traverse_content(head, output));
+
+        if (state.measure != nullptr)
+        {
+            state.measure->outputBytes = output.capacity();
+            state.measure->grow(0);
+        }
+
         break;
     }
     case INode::Type::SCOPE: {
@@ -261,21 +418,470 @@ static Result<void> traverse(std::unique_ptr<INode> const& head, std::stringstre
     }
     }
 
+    return {};
+}
+
+static Result<void> traverse(std::unique_ptr<INode> const& head, std::string& output, RenderState const& state)
+{
+    TRY(traverse_node(head, output, state));
+
     for (auto const& subnode : head->nodes)
     {
-        TRY(traverse(subnode, stream, context));
+        TRY(traverse(subnode, output, state));
     }
 
     return {};
 }
 
+// the lines are written in a single call, so the output of concurrent renders never interleaves.
+static void flush_printed(PrintSink const& sink, std::vector<std::string> const& printed)
+{
+    if (sink.type != PrintSink::Type::STDOUT || printed.empty()) return;
+    fmt::print("{}\n", fmt::join(printed, "\n"));
+}
+
+// writes the lines gathered for the STDOUT sink once it goes out of scope, even when a generator is stopped early.
+struct PrintedFlush
+{
+    PrintSink const& sink;
+    std::vector<std::string> const& printed;
+
+    ~PrintedFlush() { flush_printed(sink, printed); }
+};
+
+// binds the value of every symbol of `compiled`, variables missing from the context are bound to their own name.
+// when the context has a provider they're left unbound instead, and only get asked about once they're read.
+static void bind_values(Template const& compiled, PreprocessorContext const& context, std::vector<std::string_view>& values)
+{
+    values.clear();
+
+    for (auto const& name : compiled.symbols.names())
+    {
+        auto const* variable = context.find_variable(name);
+        if (variable != nullptr)   values.push_back(*variable);
+        else if (context.provider) values.push_back({});
+        else                       values.push_back(name);
+    }
+}
+
+// reserves the output once up front: the last render of a template is the best guess for the next one, and before
+// the first render every content is assumed to be written.
+static void reserve_output(Template const& compiled, std::string& output)
+{
+    auto const observed = compiled.lastOutputSize.load();
+    output.reserve(observed != 0 ? observed : compiled.contentBytes);
+}
+
+// renders into `scratch.output`, answering from `scratch.provided` before asking the provider. the scratch is
+// cleared first except for those answers, but keeps its capacity, so callers rendering many times can keep reusing it.
+static Result<void> render_seeded(Template const& compiled, PreprocessorContext const& context, RenderScratch& scratch, Profiler* profiler = nullptr, RenderMeasure* measure = nullptr)
+{
+    scratch.output.clear();
+    scratch.printed.clear();
+    reserve_output(compiled, scratch.output);
+
+    bind_values(compiled, context, scratch.values);
+
+    if (measure != nullptr)
+    {
+        measure->outputBytes = scratch.output.capacity();
+        measure->grow(scratch.values.capacity() * sizeof(std::string_view));
+    }
+
+    auto const result = traverse(compiled.head, scratch.output, { context, &compiled.symbols, scratch.values, &scratch.provided, &scratch.printed, nullptr, profiler, measure });
+    flush_printed(context.print, scratch.printed);
+
+    if (result.has_value()) compiled.lastOutputSize.store(scratch.output.size());
+
+    return result;
+}
+
+static Result<void> render(Template const& compiled, PreprocessorContext const& context, RenderScratch& scratch, Profiler* profiler = nullptr, RenderMeasure* measure = nullptr)
+{
+    scratch.provided.clear();
+    return render_seeded(compiled, context, scratch, profiler, measure);
+}
+
 } // namespace detail
 
 Result<std::string> interpret(std::unique_ptr<INode> const& head, PreprocessorContext const& context)
 {
-    std::stringstream sourceStream {};
-    TRY(detail::traverse(head, sourceStream, context));
-    return sourceStream.str();
+    TRY(internal::require_unbuffered(context.print));
+
+    std::string output {};
+    ProvidedValues provided {};
+    std::vector<std::string> printed {};
+    auto const result = detail::traverse(head, output, { context, nullptr, {}, &provided, &printed });
+    detail::flush_printed(context.print, printed);
+    TRY(result);
+    return output;
+}
+
+Result<std::string> interpret(Template const& compiled, PreprocessorContext const& context)
+{
+    TRY(internal::require_unbuffered(context.print));
+
+    RenderScratch scratch {};
+    TRY(detail::render(compiled, context, scratch));
+    return std::move(scratch.output);
+}
+
+Result<std::string_view> interpret(Template const& compiled, PreprocessorContext const& context, RenderScratch& scratch)
+{
+    TRY(detail::render(compiled, context, scratch));
+    return std::string_view { scratch.output };
+}
+
+Result<std::string> interpret(Template const& compiled, PreprocessorContext const& context, Profiler& profiler)
+{
+    TRY(internal::require_unbuffered(context.print));
+
+    RenderScratch scratch {};
+    TRY(detail::render(compiled, context, scratch, &profiler));
+    return std::move(scratch.output);
+}
+
+Result<std::string> interpret(Template const& compiled, PreprocessorContext const& context, Statistics& statistics)
+{
+    using Clock = std::chrono::steady_clock;
+
+    TRY(internal::require_unbuffered(context.print));
+
+    statistics.outputBytes = 0;
+    statistics.peakScratchBytes = 0;
+    statistics.variableLookups = 0;
+
+    RenderScratch scratch {};
+    detail::RenderMeasure measure { statistics };
+
+    auto const begin = Clock::now();
+    TRY(detail::render(compiled, context, scratch, nullptr, &measure));
+    statistics.interpreting = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin);
+
+    statistics.outputBytes = scratch.output.size();
+
+    return std::move(scratch.output);
+}
+
+Generator<Result<std::string_view>> interpret_chunks(Template const& compiled, PreprocessorContext const& context)
+{
+    struct Frame
+    {
+        INode const* node {};
+        std::list<std::unique_ptr<INode>>::const_iterator next {};
+        bool entered {};
+    };
+
+    if (auto const unbuffered = internal::require_unbuffered(context.print); !unbuffered.has_value())
+    {
+        co_yield make_error("{}", unbuffered.error().message());
+        co_return;
+    }
+
+    std::vector<std::string_view> values {};
+    ProvidedValues provided {};
+    std::vector<std::string> printed {};
+    detail::bind_values(compiled, context, values);
+
+    detail::PrintedFlush const flush { context.print, printed };
+    detail::RenderState const state { context, &compiled.symbols, values, &provided, &printed };
+
+    // walks the tree in the same order as `traverse`, with an explicit stack so every piece is yielded from here.
+    std::vector<Frame> stack {};
+
+    if (compiled.head == nullptr) co_yield ERROR("Head node was nullptr.");
+    else                          stack.push_back({ compiled.head.get(), compiled.head->nodes.begin() });
+
+    while (!stack.empty())
+    {
+        auto& frame = stack.back();
+
+        if (frame.entered)
+        {
+            if (frame.next == frame.node->nodes.end())
+            {
+                stack.pop_back();
+                continue;
+            }
+
+            auto const& subnode = *frame.next++;
+
+            if (subnode == nullptr)
+            {
+                co_yield ERROR("Head node was nullptr.");
+                co_return;
+            }
+
+            stack.push_back({ subnode.get(), subnode->nodes.begin() });
+            continue;
+        }
+
+        frame.entered = true;
+
+        switch (frame.node->type())
+        {
+        case INode::Type::STATEMENT: {
+            auto const branch = detail::select_branch(static_cast<IStatementNode const*>(frame.node), state);
+
+            if (!branch.has_value())
+            {
+                co_yield make_error("{}", branch.error().message());
+                co_return;
+            }
+
+            if (auto const* next = branch.value())
+            {
+                if (*next == nullptr)
+                {
+                    co_yield ERROR("Head node was nullptr.");
+                    co_return;
+                }
+
+                stack.push_back({ next->get(), (*next)->nodes.begin() });
+            }
+
+            break;
+        }
+        case INode::Type::CONTENT: {
+            std::string_view const content = static_cast<ContentNode const*>(frame.node)->content;
+
+            co_yield content;
+            if (!((content.front() == content.back()) && content.front() == '\n')) co_yield "\n"sv;
+
+            break;
+        }
+        case INode::Type::SCOPE: {
+            break;
+        }
+
+        case INode::Type::EXPRESSION:
+        case INode::Type::CONDITION:
+        case INode::Type::OPERATOR:
+        case INode::Type::LITERAL:
+
+        case INode::Type::BEGIN__:
+        case INode::Type::END__:
+        default: {
+            co_yield ERROR("Unexpected node of type \"{}\" was reached.", frame.node->type_as_string());
+            co_return;
+        }
+        }
+    }
+}
+
+void interpret_batch(Template const& compiled, std::span<PreprocessorContext const> contexts, BatchSink const& sink, BatchOptions const& options)
+{
+    std::atomic<size_t> next { 0 };
+
+    auto const fnWorker = [&] {
+        RenderScratch scratch {};
+
+        for (auto index = next.fetch_add(1); index < contexts.size(); index = next.fetch_add(1))
+        {
+            if (auto const unbuffered = internal::require_unbuffered(contexts[index].print); !unbuffered.has_value())
+                sink(index, make_error("{}", unbuffered.error().message()));
+            else if (auto const result = detail::render(compiled, contexts[index], scratch); result.has_value())
+                sink(index, std::string_view { scratch.output });
+            else
+                sink(index, make_error("{}", result.error().message()));
+        }
+    };
+
+    auto threads = options.threads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : options.threads;
+    threads = std::min(threads, contexts.size());
+
+    if (threads <= 1)
+    {
+        fnWorker();
+        return;
+    }
+
+    std::vector<std::jthread> workers {};
+    workers.reserve(threads - 1);
+
+    for (auto index = 1zu; index < threads; index += 1)
+        workers.emplace_back(fnWorker);
+
+    fnWorker();
+}
+
+std::vector<Result<std::string>> interpret_batch(Template const& compiled, std::span<PreprocessorContext const> contexts, BatchOptions const& options)
+{
+    std::vector<Result<std::string>> results(contexts.size());
+
+    interpret_batch(compiled, contexts, [&results] (size_t index, Result<std::string_view> const& output) {
+        if (output.has_value())
+            results[index] = std::string { output.value() };
+        else
+            results[index] = make_error("{}", output.error().message());
+    }, options);
+
+    return results;
+}
+
+RenderSession::RenderSession(Template const& compiled, PreprocessorContext context)
+    : _compiled { &compiled }
+    , _context { std::move(context) }
+{
+}
+
+Result<std::string_view> RenderSession::render()
+{
+    TRY(internal::require_unbuffered(_context.print));
+
+    _rendered = false;
+    _blocks.clear();
+    _provided.clear();
+    _output.clear();
+    detail::reserve_output(*_compiled, _output);
+
+    detail::bind_values(*_compiled, _context, _values);
+
+    // the parser hangs every top-level block after the first one off of it.
+    if (auto const& head = _compiled->head)
+    {
+        _blocks.push_back({ &head });
+        for (auto const& subnode : head->nodes) _blocks.push_back({ &subnode });
+    }
+
+    for (auto index = 0zu; index < _blocks.size(); index += 1)
+    {
+        _blocks[index].offset = _output.size();
+        TRY(render_block(index));
+    }
+
+    _rendered = true;
+
+    return std::string_view { _output };
+}
+
+Result<std::string_view> RenderSession::update(std::string_view name, std::string value)
+{
+    auto const* variable = _context.find_variable(name);
+    if (_rendered && variable != nullptr && *variable == value) return std::string_view { _output };
+
+    _context.environmentVariables.insert_or_assign(name, std::move(value));
+
+    if (!_rendered) return render();
+
+    auto const slot = _compiled->symbols.find(name);
+    if (!slot.has_value()) return std::string_view { _output };
+
+    // the values are views into the context, which may just have moved them.
+    detail::bind_values(*_compiled, _context, _values);
+
+    _rendered = false;
+
+    auto offset = 0zu;
+
+    for (auto index = 0zu; index < _blocks.size(); index += 1)
+    {
+        _blocks[index].offset = offset;
+        if (_blocks[index].reads[*slot]) TRY(render_block(index));
+        offset += _blocks[index].size;
+    }
+
+    _rendered = true;
+
+    return std::string_view { _output };
+}
+
+Result<void> RenderSession::render_block(size_t index)
+{
+    auto& block = _blocks[index];
+    block.reads.assign(_compiled->symbols.size(), false);
+
+    std::string output {};
+    std::vector<std::string> printed {};
+
+    detail::RenderState const state { _context, &_compiled->symbols, _values, &_provided, &printed, &block.reads };
+
+    // the first block is the head itself, whose following nodes are the other blocks.
+    auto const result = index == 0 ? detail::traverse_node(*block.node, output, state) : detail::traverse(*block.node, output, state);
+    detail::flush_printed(_context.print, printed);
+    TRY(result);
+
+    _output.replace(block.offset, block.size, output);
+    block.size = output.size();
+
+    return {};
+}
+
+GeneratedRender::GeneratedRender(PreprocessorContext const& context, std::span<std::string_view const> names)
+    : _context { context }
+    , _names { names }
+    , _values(names.size())
+{
+}
+
+GeneratedRender::~GeneratedRender()
+{
+    detail::flush_printed(_context.print, _printed);
+}
+
+std::string_view GeneratedRender::value(size_t slot)
+{
+    auto& value = _values[slot];
+
+    if (value.data() == nullptr)
+    {
+        auto const name = _names[slot];
+        if (auto const* variable = _context.find_variable(name)) value = *variable;
+        else                                                      value = detail::provide(name, _context, _provided).value_or(name);
+    }
+
+    return value;
+}
+
+Result<void> GeneratedRender::print(std::string line)
+{
+    auto const& sink = _context.print;
+
+    switch (sink.type)
+    {
+    case PrintSink::Type::STDOUT:
+    case PrintSink::Type::BUFFER: {
+        _printed.push_back(std::move(line));
+        return {};
+    }
+    case PrintSink::Type::DISCARD: {
+        return {};
+    }
+    case PrintSink::Type::CALLBACK: {
+        if (sink.callback) sink.callback(line);
+        return {};
+    }
+
+    case PrintSink::Type::BEGIN__:
+    case PrintSink::Type::END__:
+    default: {
+        break;
+    }
+    }
+
+    return ERROR("\"%PRINT\" statement had an invalid sink.");
+}
+
+Result<void> GeneratedRender::check_sink(PrintSink const& sink)
+{
+    return internal::require_unbuffered(sink);
+}
+
+std::string GeneratedRender::join(std::initializer_list<std::string_view> pieces)
+{
+    auto size = 0zu;
+    for (auto const piece : pieces) size += piece.size();
+
+    std::string result {};
+    result.reserve(size);
+    for (auto const piece : pieces) result += piece;
+
+    return result;
+}
+
+Result<std::string_view> GeneratedRender::empty_literal()
+{
+    return ERROR("Tried to interpolate an empty string.");
 }
 
 } // namespace libpreprocessor
@@ -283,12 +889,17 @@ Result<std::string> interpret(std::unique_ptr<INode> const& head, PreprocessorCo
 liberror::Result<size_t> libpreprocessor::internal::decay_to_integer(std::string_view literal)
 {
     if (literal.empty()) return ERROR("Cannot decay an empty literal.");
-    std::stringstream stream {};
-    stream << literal;
+
+    // accepts what extracting a `size_t` from a stream used to: leading whitespace, a sign, and anything after the digits.
+    auto digits = literal.substr(std::min(literal.find_first_not_of(" \t\n\v\f\r"), literal.size()));
+    auto const negative = digits.starts_with('-');
+    if (negative || digits.starts_with('+')) digits.remove_prefix(1);
+
     size_t value {};
-    stream >> value;
-    if (stream.fail()) return ERROR("Couldn't decay literal \"{}\" to a integer.", literal);
-    return value;
+    auto const [_, error] = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+    if (error != std::errc {}) return ERROR("Couldn't decay literal \"{}\" to a integer.", literal);
+
+    return negative ? 0 - value : value;
 }
 
 liberror::Result<bool> libpreprocessor::internal::decay_to_boolean(std::string_view literal)
@@ -304,45 +915,51 @@ liberror::Result<bool> libpreprocessor::internal::decay_to_boolean(std::string_v
     return static_cast<bool>(result.value());
 }
 
-liberror::Result<std::string> libpreprocessor::internal::interpolate(std::string_view string, PreprocessorContext const& context)
+liberror::Result<void> libpreprocessor::internal::require_unbuffered(PrintSink const& sink)
+{
+    if (sink.type == PrintSink::Type::BUFFER)
+        return ERROR("Lines printed to the BUFFER sink are only kept when interpreting into a RenderScratch.");
+    return {};
+}
+
+liberror::Result<std::string_view> libpreprocessor::internal::interpret_seeded(Template const& compiled, PreprocessorContext const& context, RenderScratch& scratch)
+{
+    TRY(detail::render_seeded(compiled, context, scratch));
+    return std::string_view { scratch.output };
+}
+
+// a single pass which appends every run of text up to the next pair of pipes as a whole, followed by the value of the
+// variable the pair names or the name itself if there's no such variable. every character is looked at once, so the
+// cost is linear in the size of the string and of the result. a pipe left without a closing one is kept as text, the
+// same as in compiled templates.
+liberror::Result<std::string> libpreprocessor::internal::interpolate(std::string_view string, PreprocessorContext const& context, ProvidedValues* provided)
 {
     if (string.empty()) return ERROR("Tried to interpolate an empty string.");
-    if (!string.contains("|")) return string.data();
 
-    Result<std::string> result {};
+    std::string result {};
+    result.reserve(string.size());
 
-    for (auto index = 0zu; index < string.size(); index += 1)
+    for (auto index = 0zu; index < string.size();)
     {
-        if (string.at(index) == '|')
-        {
-            auto const [_, value] = [] (this auto self, auto const& context, auto const& string, auto& index) -> std::pair<std::string, std::string> {
-                std::string result {};
+        auto const begin = string.find('|', index);
+        auto const end = begin == std::string_view::npos ? begin : string.find('|', begin + 1);
 
-                index += 1;
-                while (string.at(index) != '|')
-                {
-                    if (string.at(index) == '|') result  = self(context, string, index).first;
-                    else                         result += string.at(index++);
-                }
-                index += 1;
+        if (end == std::string_view::npos)
+        {
+            result.append(string.substr(index));
+            break;
+        }
 
-                auto const originalValue = fmt::format("|{}|", result);
-                auto const replacedValue =
-                    context.environmentVariables.contains(result)
-                        ? context.environmentVariables.at(result)
-                        : result;
+        result.append(string.substr(index, begin - index));
 
-                return { originalValue, replacedValue };
-            }(context, string, index);
+        auto const name = string.substr(begin + 1, end - begin - 1);
+        auto const* variable = context.find_variable(name);
 
-            result->append(value);
+        if (variable != nullptr)      result.append(variable->view());
+        else if (provided != nullptr) result.append(detail::provide(name, context, *provided).value_or(name));
+        else                          result.append(name);
 
-            index -= 1;
-        }
-        else
-        {
-            result->push_back(string.at(index));
-        }
+        index = end + 1;
     }
 
     return result;
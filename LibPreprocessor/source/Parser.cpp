@@ -26,6 +26,7 @@ namespace
 Result<std::unique_ptr<INode>> parse_operator(Parser& parser, Parser::Context const& context, Token const& token, std::unique_ptr<INode> node)
 {
     auto operatorNode = std::make_unique<OperatorNode>();
+    operatorNode->location = token.location;
     operatorNode->name = token.data;
     operatorNode->arity = [&] {
         auto result = std::ranges::find(operator_g, operatorNode->name, &decltype(operator_g)::value_type::first);
@@ -43,6 +44,7 @@ Result<std::unique_ptr<INode>> parse_operator(Parser& parser, Parser::Context co
         if (is_expression(node))
             return node;
         auto expression = std::make_unique<ExpressionNode>();
+        expression->location = node->location;
         expression->value = std::move(node);
         return expression;
     };
@@ -78,6 +80,7 @@ Result<std::unique_ptr<INode>> parse_if_statement(Parser& parser, Parser::Contex
     if (token.data == "IF")
     {
         auto ifStatementNode = std::make_unique<IfStatementNode>();
+        ifStatementNode->location = token.location;
         ifStatementNode->condition = TRY(parser.parse({ context.parent, context.child, Parser::Context::Who::IF_STATEMENT }));
 
         if (ifStatementNode->condition == nullptr)
@@ -110,6 +113,7 @@ Result<std::unique_ptr<INode>> parse_switch_statement(Parser& parser, Parser::Co
     if (token.data == "SWITCH")
     {
         auto switchStatementNode = std::make_unique<SwitchStatementNode>();
+        switchStatementNode->location = token.location;
         switchStatementNode->match = TRY(parser.parse({ context.parent, context.child + 1, Parser::Context::Who::SWITCH_STATEMENT }));
 
         if (switchStatementNode->match != nullptr && !is_expression(switchStatementNode->match))
@@ -132,6 +136,7 @@ Result<std::unique_ptr<INode>> parse_switch_statement(Parser& parser, Parser::Co
     else if (token.data == "CASE")
     {
         auto switchCaseNode = std::make_unique<SwitchCaseStatementNode>();
+        switchCaseNode->location = token.location;
         switchCaseNode->match = TRY(parser.parse({ context.parent, context.child + 1, Parser::Context::Who::CASE_STATEMENT }));
 
         if (switchCaseNode->match == nullptr)
@@ -151,9 +156,11 @@ Result<std::unique_ptr<INode>> parse_switch_statement(Parser& parser, Parser::Co
     else if (token.data == "DEFAULT")
     {
         auto switchCaseNode = std::make_unique<SwitchCaseStatementNode>();
+        switchCaseNode->location = token.location;
         switchCaseNode->branch = TRY(parser.parse({ context.child, context.child + 1, Parser::Context::Who::CASE_STATEMENT }));
-        switchCaseNode->match = [] {
+        switchCaseNode->match = [&token] {
             auto literalNode = std::make_unique<LiteralNode>();
+            literalNode->location = token.location;
             literalNode->value = "DEFAULT";
             return literalNode;
         }();
@@ -174,6 +181,7 @@ Result<std::unique_ptr<INode>> parse_switch_statement(Parser& parser, Parser::Co
 Result<std::unique_ptr<INode>> parse_print_statement(Parser& parser, Parser::Context const& context, Token const& token)
 {
     auto printNode = std::make_unique<PrintStatementNode>();
+    printNode->location = token.location;
     printNode->content = TRY(parser.parse({ context.parent, context.child, Parser::Context::Who::PRINT_STATEMENT }));
 
     if (printNode->content == nullptr)
@@ -234,6 +242,7 @@ Result<std::unique_ptr<INode>> Parser::parse(Context const& context)
             TRY(internal::context_identify(context, token));
 
             auto expressionNode = std::make_unique<ExpressionNode>();
+            expressionNode->location = token.location;
             expressionNode->value = TRY(parse({ context.parent, context.child, Context::Who::EXPRESSION }));
 
             if (eof())
@@ -260,6 +269,7 @@ Result<std::unique_ptr<INode>> Parser::parse(Context const& context)
             TRY(internal::context_identify(context, token));
 
             auto literalNode = std::make_unique<LiteralNode>();
+            literalNode->location = token.location;
             literalNode->value = take().data;
 
             if (eof())
@@ -280,6 +290,7 @@ Result<std::unique_ptr<INode>> Parser::parse(Context const& context)
         case Token::Type::COLON: {
             TRY(internal::context_identify(context, token));
             root = std::make_unique<ScopeNode>();
+            root.value()->location = token.location;
             break;
         }
         case Token::Type::OPERATOR: {
@@ -288,6 +299,7 @@ Result<std::unique_ptr<INode>> Parser::parse(Context const& context)
         }
         case Token::Type::CONTENT: {
             auto contentNode = std::make_unique<ContentNode>();
+            contentNode->location = token.location;
             contentNode->content = token.data;
 
             if (root.value() == nullptr)
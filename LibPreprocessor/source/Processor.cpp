@@ -1,7 +1,8 @@
 #include "Processor.hpp"
 
-#include "Lexer.hpp"
-#include "Parser.hpp"
+#include "Compiler.hpp"
+
+#include <liberror/Try.hpp>
 
 namespace libpreprocessor {
 
@@ -9,16 +10,27 @@ using namespace liberror;
 
 Result<std::string> process(std::string_view source, PreprocessorContext const& context)
 {
-    Lexer lexer { source };
-    Parser parser { lexer.tokenize() };
-    return interpret(TRY(parser.parse()), context);
+    return interpret(TRY(compile(source)), context);
 }
 
 Result<std::string> process(std::filesystem::path path, PreprocessorContext const& context)
 {
-    Lexer lexer { path };
-    Parser parser { lexer.tokenize() };
-    return interpret(TRY(parser.parse()), context);
+    return interpret(TRY(compile(path)), context);
+}
+
+Result<std::string> process(std::string_view source, PreprocessorContext const& context, Statistics& statistics)
+{
+    return interpret(TRY(compile(source, statistics)), context, statistics);
+}
+
+Result<std::string> process(std::filesystem::path path, PreprocessorContext const& context, Statistics& statistics)
+{
+    return interpret(TRY(compile(path, statistics)), context, statistics);
+}
+
+Result<std::vector<Result<std::string>>> process_batch(std::string_view source, std::span<PreprocessorContext const> contexts, BatchOptions const& options)
+{
+    return interpret_batch(TRY(compile(source)), contexts, options);
 }
 
 } // namespace libpreprocessor
@@ -0,0 +1,152 @@
+#include "Profiler.hpp"
+
+#include "nodes/IStatementNode.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+namespace libpreprocessor {
+
+namespace {
+
+std::string kind_of(INode const* node)
+{
+    if (node->type() == INode::Type::STATEMENT) return static_cast<IStatementNode const*>(node)->statement_type_as_string();
+    return node->type_as_string();
+}
+
+std::string escape_json(std::string_view string)
+{
+    std::string result {};
+    result.reserve(string.size());
+
+    for (auto const character : string)
+    {
+        switch (character)
+        {
+        case '"':  result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\n': result += "\\n"; break;
+        case '\t': result += "\\t"; break;
+        default: {
+            if (static_cast<unsigned char>(character) < 0x20) result += fmt::format("\\u{:04x}", character);
+            else                                              result += character;
+            break;
+        }
+        }
+    }
+
+    return result;
+}
+
+}
+
+Profiler::Profiler(ProfilerOptions const& options)
+    : _options { options }
+    , _origin { Clock::now() }
+{
+}
+
+void Profiler::record(INode const* node, Clock::time_point begin, Clock::time_point end)
+{
+    auto [index, inserted] = _indices.try_emplace(node, _nodes.size());
+    if (inserted) _nodes.push_back({ node->location, kind_of(node) });
+
+    auto const duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin);
+
+    _nodes[index->second].hits += 1;
+    _nodes[index->second].inclusive += duration;
+
+    if (_options.traceEvents != 0)
+    {
+        Event const event { index->second, std::chrono::duration_cast<std::chrono::nanoseconds>(begin - _origin), duration };
+
+        if (_events.size() < _options.traceEvents) _events.push_back(event);
+        else                                       _events[_recordedEvents % _options.traceEvents] = event;
+    }
+
+    _recordedEvents += 1;
+}
+
+std::vector<Profiler::Entry> Profiler::report() const
+{
+    std::map<std::tuple<std::string, size_t, std::string>, Entry> entries {};
+
+    for (auto const& node : _nodes)
+    {
+        auto& entry = entries[{ node.location.file.string(), node.location.position.first, node.kind }];
+
+        if (entry.hits == 0)
+        {
+            entry.location = node.location;
+            entry.kind = node.kind;
+        }
+
+        entry.hits += node.hits;
+        entry.inclusive += node.inclusive;
+    }
+
+    std::vector<Entry> result {};
+    result.reserve(entries.size());
+
+    for (auto& [_, entry] : entries)
+        result.push_back(std::move(entry));
+
+    std::ranges::stable_sort(result, std::ranges::greater {}, &Entry::inclusive);
+
+    return result;
+}
+
+std::string Profiler::report_as_string() const
+{
+    auto result = fmt::format("{:>14} {:>10}  {:<30} {}\n", "inclusive (ns)", "hits", "node", "location");
+
+    for (auto const& entry : report())
+    {
+        result += fmt::format("{:>14} {:>10}  {:<30} {}:{}\n", entry.inclusive.count(), entry.hits, entry.kind,
+                              entry.location.file.string(), entry.location.position.first);
+    }
+
+    return result;
+}
+
+std::string Profiler::chrome_trace() const
+{
+    std::string result = "{\"traceEvents\":[";
+
+    // once the buffer wrapped around, the oldest event is the one to be overwritten next.
+    auto const oldest = _events.empty() ? 0zu : _recordedEvents % _events.size();
+
+    for (auto index = 0zu; index < _events.size(); index += 1)
+    {
+        auto const& event = _events[(oldest + index) % _events.size()];
+        auto const& node = _nodes[event.node];
+
+        if (index != 0) result += ',';
+
+        // the trace format counts in microseconds, which still allows a fraction.
+        result += fmt::format(
+            "{{\"name\":\"{}\",\"cat\":\"libpreprocessor\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":0,\"tid\":0,"
+            "\"args\":{{\"file\":\"{}\",\"line\":{},\"column\":{}}}}}",
+            escape_json(node.kind), static_cast<double>(event.begin.count()) / 1000.0, static_cast<double>(event.duration.count()) / 1000.0,
+            escape_json(node.location.file.string()), node.location.position.first, node.location.position.second);
+    }
+
+    result += "]}";
+
+    return result;
+}
+
+void Profiler::clear()
+{
+    _nodes.clear();
+    _indices.clear();
+    _events.clear();
+    _recordedEvents = 0;
+    _origin = Clock::now();
+}
+
+} // namespace libpreprocessor
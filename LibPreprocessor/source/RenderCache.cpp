@@ -0,0 +1,155 @@
+#include "RenderCache.hpp"
+
+#include <liberror/Try.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+namespace libpreprocessor {
+
+using namespace liberror;
+
+namespace {
+
+// the values bound to every symbol of the template, which is all of the context a render of it depends on. so
+// unlike a render, this asks the provider about every variable the template names that the context doesn't hold,
+// and a render seeded with `provided` then reads the very values the key was made of.
+std::vector<std::string_view> bind_values(Template const& compiled, PreprocessorContext const& context, ProvidedValues& provided)
+{
+    std::vector<std::string_view> values {};
+    values.reserve(compiled.symbols.size());
+
+    for (auto const& name : compiled.symbols.names())
+    {
+        auto const* variable = context.find_variable(name);
+
+        if (variable != nullptr)
+        {
+            values.push_back(*variable);
+        }
+        else if (context.provider)
+        {
+            auto const& value = provided.emplace(name, context.provider(name)).first->second;
+            values.push_back(value.has_value() ? std::string_view { *value } : std::string_view { name });
+        }
+        else
+        {
+            values.push_back(name);
+        }
+    }
+
+    return values;
+}
+
+size_t hash_key(uint64_t templateId, std::vector<std::string_view> const& values)
+{
+    auto hash = std::hash<uint64_t> {}(templateId);
+
+    for (auto const value : values)
+        hash ^= std::hash<std::string_view> {}(value) + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+
+    return hash;
+}
+
+}
+
+RenderCache::RenderCache(RenderCacheOptions const& options)
+    : _options { options }
+{
+}
+
+Result<std::string> RenderCache::render(Template const& compiled, PreprocessorContext const& context)
+{
+    TRY(internal::require_unbuffered(context.print));
+
+    if (compiled.prints && context.print.type != PrintSink::Type::DISCARD)
+    {
+        return interpret(compiled, context);
+    }
+
+    RenderScratch scratch {};
+    auto const values = bind_values(compiled, context, scratch.provided);
+    auto const hash = hash_key(compiled.id, values);
+
+    {
+        std::scoped_lock const lock { _mutex };
+
+        if (auto const entry = find(compiled.id, hash, values); entry != _entries.end())
+        {
+            _hits += 1;
+            _entries.splice(_entries.begin(), _entries, entry);
+            return entry->output;
+        }
+
+        _misses += 1;
+    }
+
+    // rendering happens outside of the lock, so a miss never holds back other threads. the provider isn't asked
+    // again, as its answers for the key are what the render reads.
+    TRY(internal::interpret_seeded(compiled, context, scratch));
+    auto output = std::move(scratch.output);
+
+    std::scoped_lock const lock { _mutex };
+    if (find(compiled.id, hash, values) == _entries.end()) insert(compiled.id, hash, values, output);
+
+    return output;
+}
+
+RenderCache::Statistics RenderCache::statistics() const
+{
+    std::scoped_lock const lock { _mutex };
+    return { _hits, _misses, _entries.size(), _bytes };
+}
+
+void RenderCache::clear()
+{
+    std::scoped_lock const lock { _mutex };
+    _entries.clear();
+    _index.clear();
+    _bytes = 0;
+}
+
+RenderCache::Entries::iterator RenderCache::find(uint64_t templateId, size_t hash, std::vector<std::string_view> const& values)
+{
+    auto const [begin, end] = _index.equal_range(hash);
+
+    for (auto candidate = begin; candidate != end; ++candidate)
+    {
+        auto const& entry = *candidate->second;
+        if (entry.templateId == templateId && std::ranges::equal(entry.values, values)) return candidate->second;
+    }
+
+    return _entries.end();
+}
+
+void RenderCache::insert(uint64_t templateId, size_t hash, std::vector<std::string_view> const& values, std::string const& output)
+{
+    auto bytes = sizeof(Entry) + output.size();
+    for (auto const value : values) bytes += sizeof(std::string) + value.size();
+
+    if (bytes > _options.capacityBytes) return;
+
+    while (_bytes + bytes > _options.capacityBytes) erase(std::prev(_entries.end()));
+
+    _entries.push_front({ templateId, hash, { values.begin(), values.end() }, output, bytes });
+    _index.emplace(hash, _entries.begin());
+    _bytes += bytes;
+}
+
+void RenderCache::erase(Entries::iterator entry)
+{
+    auto const [begin, end] = _index.equal_range(entry->hash);
+
+    for (auto candidate = begin; candidate != end; ++candidate)
+    {
+        if (candidate->second != entry) continue;
+        _index.erase(candidate);
+        break;
+    }
+
+    _bytes -= entry->bytes;
+    _entries.erase(entry);
+}
+
+} // namespace libpreprocessor
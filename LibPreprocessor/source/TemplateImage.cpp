@@ -0,0 +1,346 @@
+#include "TemplateImage.hpp"
+
+#include "nodes/Nodes.hpp"
+
+#include <liberror/Try.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace libpreprocessor {
+
+using namespace liberror;
+
+#define ERROR(fmt, ...) make_error(PREFIX_ERROR ": " fmt __VA_OPT__(,) __VA_ARGS__)
+
+namespace {
+
+using internal::ImageWriter;
+using internal::image_magic_g;
+using internal::image_version_g;
+using internal::null_node_g;
+
+class ImageReader
+{
+public:
+    explicit ImageReader(std::string_view image) : _image { image } {}
+
+    bool eof() const noexcept { return _cursor == _image.size(); }
+    size_t remaining() const noexcept { return _image.size() - _cursor; }
+
+    Result<uint8_t> read_byte()
+    {
+        if (eof()) return ERROR("The template image ended unexpectedly.");
+        return static_cast<uint8_t>(_image[_cursor++]);
+    }
+
+    Result<uint64_t> read_integer()
+    {
+        uint64_t integer = 0;
+
+        for (auto index = 0zu; index < sizeof(integer); index += 1)
+            integer |= static_cast<uint64_t>(TRY(read_byte())) << (index * 8);
+
+        return integer;
+    }
+
+    Result<std::string_view> read_view(uint64_t size)
+    {
+        if (size > remaining()) return ERROR("The template image ended unexpectedly.");
+        auto const view = _image.substr(_cursor, static_cast<size_t>(size));
+        _cursor += view.size();
+        return view;
+    }
+
+    Result<std::string> read_string()
+    {
+        auto const size = TRY(read_integer());
+        return std::string { TRY(read_view(size)) };
+    }
+
+    Result<void> read_files()
+    {
+        auto const count = TRY(read_integer());
+        if (count > remaining()) return ERROR("The template image ended unexpectedly.");
+
+        for (auto index = 0zu; index < count; index += 1)
+            _files.push_back(TRY(read_string()));
+
+        return {};
+    }
+
+    Result<std::string> read_file()
+    {
+        auto const index = TRY(read_integer());
+        if (index >= _files.size()) return ERROR("The template image refers to file {}, but only holds {}.", index, _files.size());
+        return _files[static_cast<size_t>(index)];
+    }
+
+private:
+    std::string_view _image {};
+    size_t _cursor {};
+    std::vector<std::string> _files {};
+};
+
+Result<void> write_node(std::unique_ptr<INode> const& head, ImageWriter& writer);
+
+Result<void> write_statement(IStatementNode const* statementNode, ImageWriter& writer)
+{
+    writer.write_byte(static_cast<uint8_t>(statementNode->statement_type()));
+
+    switch (statementNode->statement_type())
+    {
+    case IStatementNode::Type::IF: {
+        auto const* node = static_cast<IfStatementNode const*>(statementNode);
+        TRY(write_node(node->condition, writer));
+        TRY(write_node(node->branch.first, writer));
+        TRY(write_node(node->branch.second, writer));
+        break;
+    }
+    case IStatementNode::Type::SWITCH: {
+        auto const* node = static_cast<SwitchStatementNode const*>(statementNode);
+        TRY(write_node(node->match, writer));
+        TRY(write_node(node->branches.first, writer));
+        TRY(write_node(node->branches.second, writer));
+        break;
+    }
+    case IStatementNode::Type::SWITCH_CASE: {
+        auto const* node = static_cast<SwitchCaseStatementNode const*>(statementNode);
+        TRY(write_node(node->match, writer));
+        TRY(write_node(node->branch, writer));
+        break;
+    }
+    case IStatementNode::Type::PRINT: {
+        TRY(write_node(static_cast<PrintStatementNode const*>(statementNode)->content, writer));
+        break;
+    }
+
+    case IStatementNode::Type::BEGIN__:
+    case IStatementNode::Type::END__:
+    default: {
+        return ERROR("Unexpected statement node of type \"{}\" was reached.", statementNode->statement_type_as_string());
+    }
+    }
+
+    return {};
+}
+
+// only what the parser fills in is written, what `compile` derives from it is derived again when loading.
+Result<void> write_node(std::unique_ptr<INode> const& head, ImageWriter& writer)
+{
+    if (head == nullptr)
+    {
+        writer.write_byte(null_node_g);
+        return {};
+    }
+
+    writer.write_byte(static_cast<uint8_t>(head->type()));
+    writer.write_file(head->location.file.string());
+    writer.write_integer(head->location.position.first);
+    writer.write_integer(head->location.position.second);
+
+    switch (head->type())
+    {
+    case INode::Type::STATEMENT: {
+        TRY(write_statement(static_cast<IStatementNode const*>(head.get()), writer));
+        break;
+    }
+    case INode::Type::EXPRESSION: {
+        TRY(write_node(static_cast<ExpressionNode const*>(head.get())->value, writer));
+        break;
+    }
+    case INode::Type::OPERATOR: {
+        auto const* node = static_cast<OperatorNode const*>(head.get());
+        writer.write_string(node->name);
+        writer.write_byte(static_cast<uint8_t>(node->arity));
+        TRY(write_node(node->lhs, writer));
+        TRY(write_node(node->rhs, writer));
+        break;
+    }
+    case INode::Type::LITERAL: {
+        writer.write_string(static_cast<LiteralNode const*>(head.get())->value);
+        break;
+    }
+    case INode::Type::CONTENT: {
+        writer.write_string(static_cast<ContentNode const*>(head.get())->content);
+        break;
+    }
+    case INode::Type::SCOPE: {
+        break;
+    }
+
+    case INode::Type::CONDITION:
+
+    case INode::Type::BEGIN__:
+    case INode::Type::END__:
+    default: {
+        return ERROR("Unexpected node of type \"{}\" was reached.", head->type_as_string());
+    }
+    }
+
+    writer.write_integer(head->nodes.size());
+
+    for (auto const& subnode : head->nodes)
+    {
+        TRY(write_node(subnode, writer));
+    }
+
+    return {};
+}
+
+Result<std::unique_ptr<INode>> read_node(ImageReader& reader);
+
+Result<std::unique_ptr<INode>> read_statement(ImageReader& reader)
+{
+    auto const type = TRY(reader.read_byte());
+
+    switch (static_cast<IStatementNode::Type>(type))
+    {
+    case IStatementNode::Type::IF: {
+        auto node = std::make_unique<IfStatementNode>();
+        node->condition = TRY(read_node(reader));
+        node->branch.first = TRY(read_node(reader));
+        node->branch.second = TRY(read_node(reader));
+        return node;
+    }
+    case IStatementNode::Type::SWITCH: {
+        auto node = std::make_unique<SwitchStatementNode>();
+        node->match = TRY(read_node(reader));
+        node->branches.first = TRY(read_node(reader));
+        node->branches.second = TRY(read_node(reader));
+        return node;
+    }
+    case IStatementNode::Type::SWITCH_CASE: {
+        auto node = std::make_unique<SwitchCaseStatementNode>();
+        node->match = TRY(read_node(reader));
+        node->branch = TRY(read_node(reader));
+        return node;
+    }
+    case IStatementNode::Type::PRINT: {
+        auto node = std::make_unique<PrintStatementNode>();
+        node->content = TRY(read_node(reader));
+        return node;
+    }
+
+    case IStatementNode::Type::BEGIN__:
+    case IStatementNode::Type::END__:
+    default: {
+        return ERROR("The template image holds a statement node of unknown type {}.", type);
+    }
+    }
+}
+
+Result<std::unique_ptr<INode>> read_node(ImageReader& reader)
+{
+    auto const type = TRY(reader.read_byte());
+    if (type == null_node_g) return nullptr;
+
+    auto const file = TRY(reader.read_file());
+    auto const line = TRY(reader.read_integer());
+    auto const column = TRY(reader.read_integer());
+
+    std::unique_ptr<INode> head {};
+
+    switch (static_cast<INode::Type>(type))
+    {
+    case INode::Type::STATEMENT: {
+        head = TRY(read_statement(reader));
+        break;
+    }
+    case INode::Type::EXPRESSION: {
+        auto node = std::make_unique<ExpressionNode>();
+        node->value = TRY(read_node(reader));
+        head = std::move(node);
+        break;
+    }
+    case INode::Type::OPERATOR: {
+        auto node = std::make_unique<OperatorNode>();
+        node->name = TRY(reader.read_string());
+
+        auto const arity = TRY(reader.read_byte());
+        if (arity <= static_cast<uint8_t>(OperatorNode::Arity::BEGIN__) || arity >= static_cast<uint8_t>(OperatorNode::Arity::END__))
+            return ERROR("The template image holds an operator of unknown arity {}.", arity);
+        node->arity = static_cast<OperatorNode::Arity>(arity);
+
+        node->lhs = TRY(read_node(reader));
+        node->rhs = TRY(read_node(reader));
+        head = std::move(node);
+        break;
+    }
+    case INode::Type::LITERAL: {
+        auto node = std::make_unique<LiteralNode>();
+        node->value = TRY(reader.read_string());
+        head = std::move(node);
+        break;
+    }
+    case INode::Type::CONTENT: {
+        auto node = std::make_unique<ContentNode>();
+        node->content = TRY(reader.read_string());
+        head = std::move(node);
+        break;
+    }
+    case INode::Type::SCOPE: {
+        head = std::make_unique<ScopeNode>();
+        break;
+    }
+
+    case INode::Type::CONDITION:
+
+    case INode::Type::BEGIN__:
+    case INode::Type::END__:
+    default: {
+        return ERROR("The template image holds a node of unknown type {}.", type);
+    }
+    }
+
+    head->location = { file, { static_cast<size_t>(line), static_cast<size_t>(column) } };
+
+    auto const count = TRY(reader.read_integer());
+    // every node takes at least a byte, so a count the image can't hold is refused before looping over it.
+    if (count > reader.remaining()) return ERROR("The template image ended unexpectedly.");
+
+    for (auto index = 0zu; index < count; index += 1)
+    {
+        head->nodes.push_back(TRY(read_node(reader)));
+    }
+
+    return head;
+}
+
+}
+
+Result<std::string> save_image(Template const& compiled)
+{
+    ImageWriter nodes {};
+    TRY(write_node(compiled.head, nodes));
+    return internal::finish_image(nodes);
+}
+
+Result<Template> load_image(std::string_view image)
+{
+    ImageReader reader { image };
+
+    if (TRY(reader.read_view(image_magic_g.size())) != image_magic_g)
+        return ERROR("The template image doesn't start like one.");
+    if (auto const version = TRY(reader.read_integer()); version != image_version_g)
+        return ERROR("The template image has version {}, but only version {} can be loaded.", version, image_version_g);
+
+    TRY(reader.read_files());
+
+    auto head = TRY(read_node(reader));
+    if (!reader.eof()) return ERROR("The template image has {} bytes past its end.", reader.remaining());
+
+    return compile(std::move(head));
+}
+
+Result<Template> load_embedded(std::span<EmbeddedTemplate const> templates, std::string_view name)
+{
+    auto const embedded = std::ranges::find(templates, name, &EmbeddedTemplate::name);
+    if (embedded == templates.end()) return ERROR("No template named \"{}\" was embedded.", name);
+
+    return load_image(embedded->image);
+}
+
+} // namespace libpreprocessor
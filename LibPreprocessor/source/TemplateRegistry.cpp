@@ -0,0 +1,188 @@
+#include "TemplateRegistry.hpp"
+
+#include <liberror/Try.hpp>
+
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+
+namespace libpreprocessor {
+
+using namespace liberror;
+
+#define ERROR(fmt, ...) make_error(PREFIX_ERROR ": " fmt __VA_OPT__(,) __VA_ARGS__)
+
+namespace {
+
+// read the way the lexer reads files, so what's hashed is what's compiled.
+Result<std::string> read_contents(std::filesystem::path const& path)
+{
+    std::ifstream file { path };
+    if (!file) return ERROR("Couldn't open \"{}\".", path.string());
+
+    return std::string { std::istreambuf_iterator<char> { file }, {} };
+}
+
+}
+
+TemplateRegistry::TemplateRegistry(TemplateRegistryOptions const& options)
+    : _options { options }
+{
+}
+
+// a single `stat`, which `directory_entry` caches both answers from.
+Result<TemplateRegistry::Source> TemplateRegistry::inspect(std::filesystem::path const& path)
+{
+    std::error_code error {};
+    std::filesystem::directory_entry const entry { path, error };
+
+    Source source {};
+    if (!error) source.modified = entry.last_write_time(error);
+    if (!error) source.size = entry.file_size(error);
+
+    if (error) return ERROR("Couldn't inspect \"{}\": {}.", path.string(), error.message());
+
+    return source;
+}
+
+TemplateRegistry::Shard& TemplateRegistry::shard_of(std::string const& key)
+{
+    return _shards[std::hash<std::string> {}(key) % _shards.size()];
+}
+
+Result<TemplateRegistry::Entry> TemplateRegistry::load(std::filesystem::path const& path, Source const& source, Entry const* cached)
+{
+    Entry result { nullptr, source };
+    // read once, for both hashing and compiling.
+    auto const contents = TRY(read_contents(path));
+
+    if (_options.hashContents)
+    {
+        result.source.hash = std::hash<std::string> {}(contents);
+
+        if (cached != nullptr && cached->source.hash == result.source.hash)
+        {
+            result.compiled = cached->compiled;
+            return result;
+        }
+    }
+
+    result.compiled = std::make_shared<Template const>(TRY(compile(path, contents)));
+    _compilations.fetch_add(1, std::memory_order_relaxed);
+
+    return result;
+}
+
+Result<std::shared_ptr<Template const>> TemplateRegistry::find(std::filesystem::path const& path)
+{
+    auto const key = path.lexically_normal().string();
+    auto& shard = shard_of(key);
+
+    std::optional<Entry> cached {};
+
+    {
+        std::shared_lock const lock { shard.mutex };
+
+        if (auto const entry = shard.entries.find(key); entry != shard.entries.end())
+        {
+            if (!_options.revalidate)
+            {
+                _hits.fetch_add(1, std::memory_order_relaxed);
+                return entry->second.compiled;
+            }
+
+            cached = entry->second;
+        }
+    }
+
+    // taken before compiling, so a file changing while it's compiled is noticed by the next lookup.
+    auto const source = TRY(inspect(path));
+
+    if (cached && cached->source.modified == source.modified && cached->source.size == source.size)
+    {
+        _hits.fetch_add(1, std::memory_order_relaxed);
+        return cached->compiled;
+    }
+
+    // compiled without holding the lock, so lookups of other paths in the shard aren't kept waiting. threads
+    // finding the same stale template may all compile it, and whichever finishes last is kept.
+    auto loaded = TRY(load(path, source, cached ? &*cached : nullptr));
+
+    {
+        std::unique_lock const lock { shard.mutex };
+        shard.entries.insert_or_assign(key, loaded);
+    }
+
+    return loaded.compiled;
+}
+
+Result<std::string> TemplateRegistry::process(std::filesystem::path const& path, PreprocessorContext const& context)
+{
+    auto const compiled = TRY(find(path));
+    return interpret(*compiled, context);
+}
+
+Result<void> TemplateRegistry::refresh(std::filesystem::path const& path)
+{
+    auto const key = path.lexically_normal().string();
+    auto& shard = shard_of(key);
+
+    std::optional<Entry> cached {};
+
+    {
+        std::shared_lock const lock { shard.mutex };
+
+        auto const entry = shard.entries.find(key);
+        if (entry == shard.entries.end()) return {};
+
+        cached = entry->second;
+    }
+
+    auto loaded = TRY(load(path, TRY(inspect(path)), &*cached));
+
+    std::unique_lock const lock { shard.mutex };
+
+    // a template erased while it was being compiled stays erased.
+    if (auto const entry = shard.entries.find(key); entry != shard.entries.end())
+        entry->second = std::move(loaded);
+
+    return {};
+}
+
+void TemplateRegistry::erase(std::filesystem::path const& path)
+{
+    auto const key = path.lexically_normal().string();
+    auto& shard = shard_of(key);
+
+    std::unique_lock const lock { shard.mutex };
+    shard.entries.erase(key);
+}
+
+void TemplateRegistry::clear()
+{
+    for (auto& shard : _shards)
+    {
+        std::unique_lock const lock { shard.mutex };
+        shard.entries.clear();
+    }
+}
+
+TemplateRegistry::Statistics TemplateRegistry::statistics() const
+{
+    Statistics result {
+        .hits = _hits.load(std::memory_order_relaxed),
+        .compilations = _compilations.load(std::memory_order_relaxed)
+    };
+
+    for (auto const& shard : _shards)
+    {
+        std::shared_lock const lock { shard.mutex };
+        result.entries += shard.entries.size();
+    }
+
+    return result;
+}
+
+} // namespace libpreprocessor
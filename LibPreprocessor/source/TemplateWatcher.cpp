@@ -0,0 +1,231 @@
+#include "TemplateWatcher.hpp"
+
+#include <liberror/Try.hpp>
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace libpreprocessor {
+
+using namespace liberror;
+
+#define ERROR(fmt, ...) make_error(PREFIX_ERROR ": " fmt __VA_OPT__(,) __VA_ARGS__)
+
+#if defined(__linux__)
+
+namespace {
+
+// a file written in place is closed once it's complete, one written elsewhere and renamed over is moved in.
+constexpr uint32_t changed_mask_g = IN_CLOSE_WRITE | IN_MOVED_TO;
+constexpr uint32_t removed_mask_g = IN_DELETE | IN_MOVED_FROM;
+
+}
+
+TemplateWatcher::TemplateWatcher(TemplateRegistry& registry, TemplateWatcherOptions options, int inotify, int wakeup)
+    : _registry { registry }
+    , _options { std::move(options) }
+    , _inotify { inotify }
+    , _wakeup { wakeup }
+    , _thread { [this] (std::stop_token token) { run(token); } }
+{
+}
+
+Result<std::unique_ptr<TemplateWatcher>> TemplateWatcher::create(TemplateRegistry& registry, TemplateWatcherOptions options)
+{
+    auto const inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify == -1) return ERROR("Couldn't start watching templates: {}.", std::strerror(errno));
+
+    auto const wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (wakeup == -1)
+    {
+        auto const message = std::strerror(errno);
+        close(inotify);
+        return ERROR("Couldn't start watching templates: {}.", message);
+    }
+
+    return std::unique_ptr<TemplateWatcher> { new TemplateWatcher { registry, std::move(options), inotify, wakeup } };
+}
+
+TemplateWatcher::~TemplateWatcher()
+{
+    _thread.request_stop();
+
+    uint64_t const one = 1;
+    [[maybe_unused]] auto const written = write(_wakeup, &one, sizeof(one));
+
+    _thread.join();
+
+    close(_wakeup);
+    close(_inotify);
+}
+
+Result<void> TemplateWatcher::watch(std::filesystem::path const& path)
+{
+    std::error_code error {};
+    auto const status = std::filesystem::status(path, error);
+
+    if (error) return ERROR("Couldn't watch \"{}\": {}.", path.string(), error.message());
+    if (!std::filesystem::exists(status)) return ERROR("Couldn't watch \"{}\", as it doesn't exist.", path.string());
+
+    auto const everything = std::filesystem::is_directory(status);
+    auto const directory = everything ? path : (path.has_parent_path() ? path.parent_path() : std::filesystem::path { "." });
+
+    auto const descriptor = inotify_add_watch(_inotify, directory.c_str(), changed_mask_g | removed_mask_g);
+    if (descriptor == -1) return ERROR("Couldn't watch \"{}\": {}.", path.string(), std::strerror(errno));
+
+    std::scoped_lock const lock { _mutex };
+
+    // watching a directory twice gives back the same descriptor, so whatever was watched of it before is kept.
+    auto& watch = _watches[descriptor];
+    watch.directory = directory;
+    if (everything) watch.everything = true;
+    else            watch.files.insert(path.filename().string());
+
+    return {};
+}
+
+void TemplateWatcher::refresh(std::filesystem::path const& path)
+{
+    auto const result = _registry.refresh(path);
+    if (!result.has_value() && _options.onError) _options.onError(path, result.error().message());
+}
+
+// after the kernel dropped events, any watched file may have changed unnoticed.
+void TemplateWatcher::refresh_everything()
+{
+    std::vector<std::filesystem::path> paths {};
+
+    {
+        std::scoped_lock const lock { _mutex };
+
+        for (auto const& [_, watch] : _watches)
+        {
+            for (auto const& file : watch.files)
+                paths.push_back(watch.directory / file);
+
+            if (!watch.everything) continue;
+
+            std::error_code error {};
+            for (auto const& entry : std::filesystem::directory_iterator { watch.directory, error })
+                paths.push_back(entry.path());
+        }
+    }
+
+    for (auto const& path : paths)
+        refresh(path);
+}
+
+void TemplateWatcher::run(std::stop_token const& token)
+{
+    std::array descriptors {
+        pollfd { .fd = _inotify, .events = POLLIN, .revents = 0 },
+        pollfd { .fd = _wakeup, .events = POLLIN, .revents = 0 }
+    };
+
+    alignas(inotify_event) std::array<char, 16 * 1024> buffer {};
+
+    while (!token.stop_requested())
+    {
+        if (poll(descriptors.data(), descriptors.size(), -1) == -1)
+        {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (descriptors[1].revents != 0) break;
+
+        auto const size = read(_inotify, buffer.data(), buffer.size());
+        if (size <= 0) continue;
+
+        // a file usually changes with several events at once, so they're gathered before compiling anything.
+        std::set<std::filesystem::path> changed {};
+        std::set<std::filesystem::path> removed {};
+        auto overflowed = false;
+
+        {
+            std::scoped_lock const lock { _mutex };
+
+            for (auto offset = 0zu; offset < static_cast<size_t>(size);)
+            {
+                inotify_event event {};
+                std::memcpy(&event, buffer.data() + offset, sizeof(event));
+
+                auto const* const nameBegin = buffer.data() + offset + sizeof(event);
+                offset += sizeof(event) + event.len;
+
+                if ((event.mask & IN_Q_OVERFLOW) != 0) overflowed = true;
+                // events about the directory itself have no name.
+                if (event.len == 0) continue;
+
+                // padded with null characters up to `len`.
+                std::string_view const name { nameBegin };
+
+                auto const watch = _watches.find(event.wd);
+                if (watch == _watches.end()) continue;
+                if (!watch->second.everything && !watch->second.files.contains(name)) continue;
+
+                auto path = watch->second.directory / name;
+
+                if ((event.mask & removed_mask_g) != 0)
+                {
+                    changed.erase(path);
+                    removed.insert(std::move(path));
+                }
+                else
+                {
+                    removed.erase(path);
+                    changed.insert(std::move(path));
+                }
+            }
+        }
+
+        for (auto const& path : removed)
+            _registry.erase(path);
+
+        for (auto const& path : changed)
+            refresh(path);
+
+        if (overflowed) refresh_everything();
+    }
+}
+
+#else
+
+TemplateWatcher::TemplateWatcher(TemplateRegistry& registry, TemplateWatcherOptions options, int inotify, int wakeup)
+    : _registry { registry }
+    , _options { std::move(options) }
+    , _inotify { inotify }
+    , _wakeup { wakeup }
+{
+}
+
+Result<std::unique_ptr<TemplateWatcher>> TemplateWatcher::create(TemplateRegistry&, TemplateWatcherOptions)
+{
+    return ERROR("Watching templates is only supported on Linux.");
+}
+
+TemplateWatcher::~TemplateWatcher() = default;
+
+Result<void> TemplateWatcher::watch(std::filesystem::path const& path)
+{
+    return ERROR("Couldn't watch \"{}\", as watching templates is only supported on Linux.", path.string());
+}
+
+void TemplateWatcher::refresh(std::filesystem::path const&) {}
+void TemplateWatcher::refresh_everything() {}
+void TemplateWatcher::run(std::stop_token const&) {}
+
+#endif
+
+} // namespace libpreprocessor
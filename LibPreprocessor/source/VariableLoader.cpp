@@ -0,0 +1,199 @@
+#include "VariableLoader.hpp"
+
+#include <liberror/Try.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#if defined(_WIN32)
+#define NOGDI
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+// wingdi.h defines it, and NOGDI only keeps it out when nothing else included windows.h first.
+#undef ERROR
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace libpreprocessor {
+
+using namespace liberror;
+
+#define ERROR(fmt, ...) make_error(PREFIX_ERROR ": " fmt __VA_OPT__(,) __VA_ARGS__)
+
+namespace {
+
+// roughly what a `NAME=value` line takes, to size the map from the file without reading it twice.
+constexpr size_t estimated_line_bytes_g = 24;
+
+// a read-only view of a whole file, which stays valid for as long as the mapping lives.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    ~MappedFile()
+    {
+#if defined(_WIN32)
+        if (_view != nullptr) UnmapViewOfFile(_view);
+        if (_mapping != nullptr) CloseHandle(_mapping);
+        if (_file != INVALID_HANDLE_VALUE) CloseHandle(_file);
+#else
+        if (_view != nullptr) munmap(_view, _size);
+        if (_file != -1) close(_file);
+#endif
+    }
+
+    static Result<std::unique_ptr<MappedFile>> open(std::filesystem::path const& path)
+    {
+        auto result = std::make_unique<MappedFile>();
+
+#if defined(_WIN32)
+        result->_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (result->_file == INVALID_HANDLE_VALUE) return ERROR("Couldn't open \"{}\".", path.string());
+
+        LARGE_INTEGER size {};
+        if (!GetFileSizeEx(result->_file, &size)) return ERROR("Couldn't tell the size of \"{}\".", path.string());
+        result->_size = static_cast<size_t>(size.QuadPart);
+
+        // a file without contents can't be mapped, but there's nothing to read from it either.
+        if (result->_size == 0) return result;
+
+        result->_mapping = CreateFileMappingW(result->_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (result->_mapping == nullptr) return ERROR("Couldn't map \"{}\".", path.string());
+
+        result->_view = MapViewOfFile(result->_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (result->_view == nullptr) return ERROR("Couldn't map \"{}\".", path.string());
+#else
+        result->_file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (result->_file == -1) return ERROR("Couldn't open \"{}\": {}.", path.string(), std::strerror(errno));
+
+        struct stat status {};
+        if (fstat(result->_file, &status) == -1) return ERROR("Couldn't tell the size of \"{}\": {}.", path.string(), std::strerror(errno));
+        result->_size = static_cast<size_t>(status.st_size);
+
+        if (result->_size == 0) return result;
+
+        auto* const view = mmap(nullptr, result->_size, PROT_READ, MAP_PRIVATE, result->_file, 0);
+        if (view == MAP_FAILED) return ERROR("Couldn't map \"{}\": {}.", path.string(), std::strerror(errno));
+        result->_view = view;
+
+        // the file is read once from start to end.
+        madvise(result->_view, result->_size, MADV_SEQUENTIAL);
+#endif
+
+        return result;
+    }
+
+    std::string_view contents() const noexcept
+    {
+        if (_view == nullptr) return {};
+        return { static_cast<char const*>(_view), _size };
+    }
+
+private:
+#if defined(_WIN32)
+    HANDLE _file { INVALID_HANDLE_VALUE };
+    HANDLE _mapping {};
+#else
+    int _file { -1 };
+#endif
+    void* _view {};
+    size_t _size {};
+};
+
+std::string_view trim(std::string_view string)
+{
+    auto const begin = string.find_first_not_of(" \t\r");
+    if (begin == std::string_view::npos) return {};
+    return string.substr(begin, string.find_last_not_of(" \t\r") - begin + 1);
+}
+
+std::string_view unquote(std::string_view value)
+{
+    if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') && value.back() == value.front())
+        return value.substr(1, value.size() - 2);
+    return value;
+}
+
+}
+
+Result<void> parse_variables(std::string_view source, VariableMap& variables)
+{
+    // every entry takes a line, so files of typical lines rarely make the map grow while it's being filled.
+    variables.reserve(variables.size() + source.size() / estimated_line_bytes_g + 1);
+
+    auto lineNumber = 0zu;
+
+    for (auto begin = 0zu; begin < source.size();)
+    {
+        auto const end = std::min(source.find('\n', begin), source.size());
+        auto line = trim(source.substr(begin, end - begin));
+
+        begin = end + 1;
+        lineNumber += 1;
+
+        if (line.empty() || line.front() == '#') continue;
+
+        if (line.starts_with("export ") || line.starts_with("export\t")) line = trim(line.substr(6));
+
+        auto const separator = line.find('=');
+        if (separator == std::string_view::npos)
+            return ERROR("Line {} has no \"=\" separating a name from its value.", lineNumber);
+
+        auto const name = trim(line.substr(0, separator));
+        if (name.empty())
+            return ERROR("Line {} defines a variable without a name.", lineNumber);
+
+        variables.insert_or_assign(name, unquote(trim(line.substr(separator + 1))));
+    }
+
+    return {};
+}
+
+Result<void> load_variables(std::filesystem::path const& path, VariableMap& variables)
+{
+    auto const file = TRY(MappedFile::open(path));
+    return parse_variables(file->contents(), variables);
+}
+
+void load_process_environment(VariableMap& variables)
+{
+#if defined(_WIN32)
+    auto** const environment = _environ;
+#else
+    auto** const environment = environ;
+#endif
+
+    if (environment == nullptr) return;
+
+    auto count = 0zu;
+    while (environment[count] != nullptr) count += 1;
+
+    variables.reserve(variables.size() + count);
+
+    for (auto index = 0zu; index < count; index += 1)
+    {
+        std::string_view const entry { environment[index] };
+
+        // windows keeps the current directory of every drive in variables named like `=C:`, which aren't variables.
+        auto const separator = entry.find('=', 1);
+        if (separator == std::string_view::npos) continue;
+
+        variables.insert_or_assign(entry.substr(0, separator), entry.substr(separator + 1));
+    }
+}
+
+} // namespace libpreprocessor
@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+
+#include <libpreprocessor/Processor.hpp>
+
+#include <string>
+#include <vector>
+
+static constexpr auto source_g =
+    "tenant report\n"
+    "%IF [<|ENV:TENANT|> CONTAINS <premium>]:\n"
+    "    %SWITCH [<|ENV:REGION|>]:\n"
+    "        %CASE [<eu>]:\n"
+    "            premium europe\n"
+    "        %END\n"
+    "        %CASE [<us>]:\n"
+    "            premium america\n"
+    "        %END\n"
+    "        %DEFAULT:\n"
+    "            premium elsewhere\n"
+    "        %END\n"
+    "    %END\n"
+    "%ELSE:\n"
+    "    standard\n"
+    "%END\n"
+    "end of report\n";
+
+static std::vector<libpreprocessor::PreprocessorContext> make_contexts(int64_t count)
+{
+    std::vector<libpreprocessor::PreprocessorContext> contexts {};
+
+    for (auto index = 0; index < count; index += 1)
+    {
+        contexts.push_back({
+            .environmentVariables = {
+                { "ENV:TENANT", (index % 2 ? "premium-" : "tenant-") + std::to_string(index) },
+                { "ENV:REGION", index % 3 ? "eu" : "us" }
+            }
+        });
+    }
+
+    return contexts;
+}
+
+static void BM_process_loop(benchmark::State& state)
+{
+    auto const contexts = make_contexts(state.range(0));
+
+    for (auto _ : state)
+    {
+        for (auto const& context : contexts)
+        {
+            auto result = libpreprocessor::process(std::string_view { source_g }, context);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_process_batch(benchmark::State& state)
+{
+    auto const contexts = make_contexts(state.range(0));
+    auto const threads = static_cast<size_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        auto result = libpreprocessor::process_batch(source_g, contexts, { .threads = threads });
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_process_loop)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_process_batch)->Args({ 1000, 1 })->Args({ 1000, 0 })->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/Interpreter.hpp>
+
+#include <string>
+
+static constexpr auto source_g =
+    "%SWITCH [<|ENV:REGION|>]:\n"
+    "    %CASE [<eu>]:\n"
+    "        region eu\n"
+    "    %END\n"
+    "    %CASE [<us>]:\n"
+    "        region us\n"
+    "    %END\n"
+    "%END\n"
+    "%IF [[<|ENV:TENANT|> CONTAINS <premium>] AND <|ENV:ENABLED|>]:\n"
+    "    premium!\n"
+    "%ELSE:\n"
+    "    standard!\n"
+    "%END\n";
+
+// every thread renders the same compiled template with its own scratch, so throughput should grow with the
+// thread count for as long as there are cores left.
+static void BM_concurrent_render(benchmark::State& state)
+{
+    static auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+
+    if (!compiled.has_value())
+    {
+        state.SkipWithError(compiled.error().message().data());
+        return;
+    }
+
+    libpreprocessor::PreprocessorContext const context {
+        .environmentVariables = {
+            { "ENV:REGION", "us" },
+            { "ENV:TENANT", "premium-" + std::to_string(state.thread_index()) },
+            { "ENV:ENABLED", "TRUE" }
+        }
+    };
+
+    libpreprocessor::RenderScratch scratch {};
+
+    for (auto _ : state)
+    {
+        auto result = libpreprocessor::interpret(compiled.value(), context, scratch);
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_concurrent_render)->ThreadRange(1, 16)->UseRealTime();
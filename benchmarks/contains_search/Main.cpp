@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+
+#include <libpreprocessor/Searcher.hpp>
+
+#include <string>
+
+// the needle only shows up at the very end, after plenty of near misses.
+static std::string make_haystack(int64_t size)
+{
+    std::string haystack {};
+
+    while (haystack.size() + 16 < static_cast<size_t>(size))
+        haystack += "feature-flag-on,";
+
+    return haystack + "feature-needle";
+}
+
+static void search_with_contains(benchmark::State& state, std::string const& needle)
+{
+    auto const haystack = make_haystack(state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(haystack.contains(needle));
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(haystack.size()));
+}
+
+static void search_with_searcher(benchmark::State& state, std::string const& needle)
+{
+    auto const haystack = make_haystack(state.range(0));
+    libpreprocessor::Searcher const searcher { needle };
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(searcher.found_in(haystack));
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(haystack.size()));
+}
+
+static void BM_contains_short_needle(benchmark::State& state)  { search_with_contains(state, "needle"); }
+static void BM_searcher_short_needle(benchmark::State& state)  { search_with_searcher(state, "needle"); }
+static void BM_contains_long_needle(benchmark::State& state)   { search_with_contains(state, "feature-needle"); }
+static void BM_searcher_long_needle(benchmark::State& state)   { search_with_searcher(state, "feature-needle"); }
+
+BENCHMARK(BM_contains_short_needle)->RangeMultiplier(8)->Range(64, 256 << 10);
+BENCHMARK(BM_searcher_short_needle)->RangeMultiplier(8)->Range(64, 256 << 10);
+BENCHMARK(BM_contains_long_needle)->RangeMultiplier(8)->Range(64, 256 << 10);
+BENCHMARK(BM_searcher_long_needle)->RangeMultiplier(8)->Range(64, 256 << 10);
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/Interpreter.hpp>
+#include <libpreprocessor/Lexer.hpp>
+#include <libpreprocessor/Parser.hpp>
+
+#include <fmt/format.h>
+
+#include <string>
+
+// a single literal holding `references` variables separated by text, half of which the context doesn't define.
+static std::string make_source(int64_t references)
+{
+    std::string literal {};
+
+    for (auto index = 0; index < references; index += 1)
+        literal += fmt::format("|ENV:{}|, ", index);
+
+    return fmt::format("%IF [<{}> EQUALS <x>]:\n    matched\n%END\n", literal);
+}
+
+static libpreprocessor::PreprocessorContext make_context(int64_t references)
+{
+    libpreprocessor::PreprocessorContext context {};
+
+    for (auto index = 0; index < references; index += 2)
+        context.environmentVariables.insert_or_assign(fmt::format("ENV:{}", index), "value");
+
+    return context;
+}
+
+static void BM_interpolate_uncompiled(benchmark::State& state)
+{
+    auto const source = make_source(state.range(0));
+    auto const context = make_context(state.range(0));
+
+    libpreprocessor::Lexer lexer { std::string_view { source } };
+    libpreprocessor::Parser parser { lexer.tokenize() };
+    auto const head = parser.parse();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(libpreprocessor::interpret(head.value(), context));
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+
+static void BM_interpolate_compiled(benchmark::State& state)
+{
+    auto const source = make_source(state.range(0));
+    auto const context = make_context(state.range(0));
+    auto const compiled = libpreprocessor::compile(std::string_view { source });
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(libpreprocessor::interpret(compiled.value(), context));
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(BM_interpolate_uncompiled)->RangeMultiplier(4)->Range(16, 16 << 10)->Complexity(benchmark::oN);
+BENCHMARK(BM_interpolate_compiled)->RangeMultiplier(4)->Range(16, 16 << 10)->Complexity(benchmark::oN);
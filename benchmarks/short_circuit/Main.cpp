@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/Interpreter.hpp>
+
+#include <cstdint>
+#include <string>
+
+static std::string make_expensive_expression(int64_t depth)
+{
+    std::string expression = "[<|ENV:LIST|> CONTAINS <needle>]";
+
+    for (auto index = 0; index < depth; index += 1)
+    {
+        expression = "[[<|ENV:LIST|> CONTAINS <needle>] AND " + expression + "]";
+    }
+
+    return expression;
+}
+
+static std::string make_source(int64_t depth)
+{
+    return "%IF [[<|ENV:A|> EQUALS <x>] OR " + make_expensive_expression(depth) + "]:\n"
+           "    hello!\n"
+           "%END\n";
+}
+
+static void evaluate_condition(benchmark::State& state, std::string const& value)
+{
+    libpreprocessor::PreprocessorContext context {
+        .environmentVariables = {
+            { "ENV:A", value },
+            { "ENV:LIST", std::string(4096, 'a') + "needle" }
+        }
+    };
+
+    auto const source = make_source(state.range(0));
+
+    auto const compiled = libpreprocessor::compile(std::string_view { source });
+
+    if (!compiled.has_value())
+    {
+        state.SkipWithError(compiled.error().message().data());
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        auto result = libpreprocessor::interpret(compiled.value(), context);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+static void BM_short_circuited_right_hand_side(benchmark::State& state)
+{
+    evaluate_condition(state, "x");
+}
+
+static void BM_evaluated_right_hand_side(benchmark::State& state)
+{
+    evaluate_condition(state, "y");
+}
+
+BENCHMARK(BM_short_circuited_right_hand_side)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK(BM_evaluated_right_hand_side)->RangeMultiplier(4)->Range(1, 64);
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/Interpreter.hpp>
+#include <libpreprocessor/Lexer.hpp>
+#include <libpreprocessor/Parser.hpp>
+
+#include <string>
+
+static std::string make_source(int64_t cases)
+{
+    std::string source = "%SWITCH [<|ENV:X|>]:\n";
+    for (auto index = 0; index < cases; index += 1)
+    {
+        source += "    %CASE [<" + std::to_string(index) + ">]:\n        case " + std::to_string(index) + "!\n    %END\n";
+    }
+    return source + "%END\n";
+}
+
+// the last case is the worst case for a linear scan over the labels.
+static libpreprocessor::PreprocessorContext make_context(int64_t cases)
+{
+    return {
+        .environmentVariables = {
+            { "ENV:X", std::to_string(cases - 1) }
+        }
+    };
+}
+
+static void BM_linear_switch(benchmark::State& state)
+{
+    auto const source = make_source(state.range(0));
+    auto const context = make_context(state.range(0));
+
+    libpreprocessor::Lexer lexer { std::string_view { source } };
+    libpreprocessor::Parser parser { lexer.tokenize() };
+    auto const head = parser.parse();
+
+    if (!head.has_value())
+    {
+        state.SkipWithError(head.error().message().data());
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        auto result = libpreprocessor::interpret(head.value(), context);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+static void BM_hashed_switch(benchmark::State& state)
+{
+    auto const source = make_source(state.range(0));
+    auto const context = make_context(state.range(0));
+
+    auto const compiled = libpreprocessor::compile(std::string_view { source });
+
+    if (!compiled.has_value())
+    {
+        state.SkipWithError(compiled.error().message().data());
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        auto result = libpreprocessor::interpret(compiled.value(), context);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+BENCHMARK(BM_linear_switch)->RangeMultiplier(4)->Range(4, 1024);
+BENCHMARK(BM_hashed_switch)->RangeMultiplier(4)->Range(4, 1024);
@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include <libpreprocessor/Processor.hpp>
+#include <libpreprocessor/TemplateRegistry.hpp>
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static std::vector<std::filesystem::path> make_templates(int64_t count)
+{
+    auto const directory = std::filesystem::temp_directory_path() / "benchmark_template_registry";
+    std::filesystem::create_directories(directory);
+
+    std::vector<std::filesystem::path> paths {};
+
+    for (auto index = 0; index < count; index += 1)
+    {
+        auto const path = directory / fmt::format("{}.txt", index);
+        std::ofstream { path, std::ios::binary }
+            << "%SWITCH [<|ENV:REGION|>]:\n"
+               "    %CASE [<eu>]:\n"
+               "        region eu\n"
+               "    %END\n"
+               "    %DEFAULT:\n"
+               "        region unknown\n"
+               "    %END\n"
+               "%END\n"
+               "%IF [<|ENV:DEBUG|>]:\n"
+               "    debug build\n"
+               "%END\n";
+        paths.push_back(path);
+    }
+
+    return paths;
+}
+
+static libpreprocessor::PreprocessorContext const context_g {
+    .environmentVariables = { { "ENV:REGION", "eu" }, { "ENV:DEBUG", "FALSE" } }
+};
+
+// reading and parsing every template on every render, as `process` does.
+static void BM_process_path(benchmark::State& state)
+{
+    auto const paths = make_templates(state.range(0));
+
+    for (auto _ : state)
+    {
+        for (auto const& path : paths)
+            benchmark::DoNotOptimize(libpreprocessor::process(path, context_g));
+    }
+
+    std::filesystem::remove_all(paths.front().parent_path());
+}
+
+static void BM_registry_process(benchmark::State& state)
+{
+    auto const paths = make_templates(state.range(0));
+    libpreprocessor::TemplateRegistry registry {};
+
+    for (auto _ : state)
+    {
+        for (auto const& path : paths)
+            benchmark::DoNotOptimize(registry.process(path, context_g));
+    }
+
+    std::filesystem::remove_all(paths.front().parent_path());
+}
+
+BENCHMARK(BM_process_path)->Arg(100)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_registry_process)->Arg(100)->Unit(benchmark::kMicrosecond);
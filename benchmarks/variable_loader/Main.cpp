@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include <libpreprocessor/VariableLoader.hpp>
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+static std::string make_source(int64_t entries)
+{
+    std::string source {};
+
+    for (auto index = 0; index < entries; index += 1)
+        source += fmt::format("ENV:VARIABLE_{}=value of variable number {}\n", index, index);
+
+    return source;
+}
+
+// what loading a file used to look like: reading it through a stream and splitting it line by line.
+static void BM_load_with_getline(benchmark::State& state)
+{
+    auto const path = std::filesystem::temp_directory_path() / "benchmark_variable_loader.env";
+    std::ofstream { path, std::ios::binary } << make_source(state.range(0));
+
+    for (auto _ : state)
+    {
+        libpreprocessor::VariableMap variables {};
+
+        std::ifstream stream { path };
+        std::string line {};
+
+        while (std::getline(stream, line))
+        {
+            auto const separator = line.find('=');
+            variables.insert_or_assign(line.substr(0, separator), line.substr(separator + 1));
+        }
+
+        benchmark::DoNotOptimize(variables);
+    }
+
+    std::filesystem::remove(path);
+}
+
+static void BM_load_variables(benchmark::State& state)
+{
+    auto const path = std::filesystem::temp_directory_path() / "benchmark_variable_loader.env";
+    std::ofstream { path, std::ios::binary } << make_source(state.range(0));
+
+    for (auto _ : state)
+    {
+        libpreprocessor::VariableMap variables {};
+        benchmark::DoNotOptimize(libpreprocessor::load_variables(path, variables));
+        benchmark::DoNotOptimize(variables);
+    }
+
+    std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_load_with_getline)->Arg(100'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_load_variables)->Arg(100'000)->Unit(benchmark::kMillisecond);
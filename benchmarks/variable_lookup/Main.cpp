@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include <libpreprocessor/VariableMap.hpp>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+static std::vector<std::string> make_names(int64_t count)
+{
+    std::vector<std::string> names {};
+    for (auto index = 0; index < count; index += 1)
+        names.push_back("ENV:VARIABLE_" + std::to_string(index));
+    return names;
+}
+
+// every lookup is made through a `std::string_view`, as the interpreter holds the names inside the template.
+static std::vector<std::string_view> make_queries(std::vector<std::string> const& names)
+{
+    std::vector<std::string_view> queries {};
+    for (auto index = 0zu; index < names.size(); index += 7)
+        queries.push_back(names[index]);
+    queries.push_back("ENV:MISSING");
+    return queries;
+}
+
+static void BM_unordered_map_lookup(benchmark::State& state)
+{
+    auto const names = make_names(state.range(0));
+    auto const queries = make_queries(names);
+
+    std::unordered_map<std::string, std::string> variables {};
+    for (auto const& name : names) variables.emplace(name, name);
+
+    for (auto _ : state)
+    {
+        for (auto const query : queries)
+        {
+            std::string const key { query };
+            auto const& value = variables.contains(key) ? variables.at(key) : key;
+            benchmark::DoNotOptimize(value.data());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(queries.size()));
+}
+
+static void BM_variable_map_lookup(benchmark::State& state)
+{
+    auto const names = make_names(state.range(0));
+    auto const queries = make_queries(names);
+
+    libpreprocessor::VariableMap variables {};
+    for (auto const& name : names) variables.insert(name, name);
+
+    for (auto _ : state)
+    {
+        for (auto const query : queries)
+        {
+            auto const variable = variables.find(query);
+            auto const value = variable != variables.end() ? std::string_view { variable->second } : query;
+            benchmark::DoNotOptimize(value.data());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(queries.size()));
+}
+
+BENCHMARK(BM_unordered_map_lookup)->RangeMultiplier(10)->Range(10, 10000);
+BENCHMARK(BM_variable_map_lookup)->RangeMultiplier(10)->Range(10, 10000);
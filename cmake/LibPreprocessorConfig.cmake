@@ -1 +1,2 @@
 include("${CMAKE_CURRENT_LIST_DIR}/LibPreprocessorTargets.cmake")
+include("${CMAKE_CURRENT_LIST_DIR}/generate_templates.cmake")
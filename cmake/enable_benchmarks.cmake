@@ -0,0 +1,17 @@
+function(enable_benchmarks PROJECT)
+
+    message(STATUS "[${PROJECT}] benchmarks are enabled.")
+
+    set(LibPreprocessor_BenchmarksCompilerOptions ${LibPreprocessor_BenchmarksCompilerOptions} ${LibPreprocessor_CompilerOptions})
+    set(LibPreprocessor_BenchmarksLinkerOptions ${LibPreprocessor_BenchmarksLinkerOptions} ${LibPreprocessor_LinkerOptions})
+
+    CPMAddPackage(
+        NAME benchmark
+        GITHUB_REPOSITORY google/benchmark
+        VERSION 1.8.3
+        OPTIONS "BENCHMARK_ENABLE_TESTING OFF" "BENCHMARK_ENABLE_INSTALL OFF" "BENCHMARK_ENABLE_GTEST_TESTS OFF"
+    )
+
+    add_subdirectory(benchmarks)
+
+endfunction()
@@ -0,0 +1,120 @@
+# generates a header at build time from `TEMPLATE`, defining `FUNCTION` (inside `NAMESPACE`, when given) to render
+# it as straight-line C++ instead of interpreting it, see `libpreprocessor::generate_cpp`. `TARGET` can include it as
+# `<libpreprocessor_generated/FUNCTION.hpp>`, and it's generated again whenever the template changes.
+function(libpreprocessor_generate_template TARGET)
+
+    cmake_parse_arguments(PARSE_ARGV 1 ARGS "" "TEMPLATE;FUNCTION;NAMESPACE" "")
+
+    if (NOT ARGS_TEMPLATE OR NOT ARGS_FUNCTION)
+        message(FATAL_ERROR "libpreprocessor_generate_template expects both a TEMPLATE and a FUNCTION.")
+    endif()
+
+    cmake_path(ABSOLUTE_PATH ARGS_TEMPLATE BASE_DIRECTORY "${CMAKE_CURRENT_SOURCE_DIR}" NORMALIZE)
+
+    set(GENERATED_HEADER "${CMAKE_CURRENT_BINARY_DIR}/libpreprocessor_generated/${ARGS_FUNCTION}.hpp")
+
+    add_custom_command(
+        OUTPUT  "${GENERATED_HEADER}"
+        COMMAND LibPreprocessor::libpreprocessor_codegen "${ARGS_TEMPLATE}" "${GENERATED_HEADER}" ${ARGS_FUNCTION} ${ARGS_NAMESPACE}
+        DEPENDS LibPreprocessor::libpreprocessor_codegen "${ARGS_TEMPLATE}"
+        COMMENT "Generating ${ARGS_FUNCTION} from ${ARGS_TEMPLATE}"
+        VERBATIM
+    )
+
+    target_sources(${TARGET} PRIVATE "${GENERATED_HEADER}")
+    target_include_directories(${TARGET} PRIVATE "${CMAKE_CURRENT_BINARY_DIR}")
+
+endfunction()
+
+# compiles every template in `FILES` into an image at build time, see `libpreprocessor::save_image`, and links them
+# all into `TARGET`. `TARGET` can include `<libpreprocessor_generated/FUNCTION.hpp>`, declaring `FUNCTION`
+# (`embedded_templates` unless given, inside `NAMESPACE` when given) to list them for `libpreprocessor::load_embedded`
+# by their path relative to the current source directory. every template has its own image, compiled again only
+# when that template changes.
+function(libpreprocessor_embed_templates TARGET)
+
+    cmake_parse_arguments(PARSE_ARGV 1 ARGS "" "FUNCTION;NAMESPACE" "FILES")
+
+    if (NOT ARGS_FILES)
+        message(FATAL_ERROR "libpreprocessor_embed_templates expects at least one of FILES.")
+    endif()
+
+    if (NOT ARGS_FUNCTION)
+        set(ARGS_FUNCTION embedded_templates)
+    endif()
+
+    if (ARGS_NAMESPACE)
+        set(NAMESPACE_BEGIN "namespace ${ARGS_NAMESPACE} {\n\n")
+        set(NAMESPACE_END "\n} // namespace ${ARGS_NAMESPACE}\n")
+    endif()
+
+    set(GENERATED_DIRECTORY "${CMAKE_CURRENT_BINARY_DIR}/libpreprocessor_generated")
+    set(IMAGE_DECLARATIONS "")
+    set(IMAGE_ENTRIES "")
+    set(IMAGE_INDEX 0)
+
+    foreach (TEMPLATE IN LISTS ARGS_FILES)
+        cmake_path(ABSOLUTE_PATH TEMPLATE BASE_DIRECTORY "${CMAKE_CURRENT_SOURCE_DIR}" NORMALIZE)
+        cmake_path(RELATIVE_PATH TEMPLATE BASE_DIRECTORY "${CMAKE_CURRENT_SOURCE_DIR}" OUTPUT_VARIABLE TEMPLATE_NAME)
+
+        set(IMAGE_SYMBOL "${ARGS_FUNCTION}_image_${IMAGE_INDEX}")
+        set(IMAGE_SOURCE "${GENERATED_DIRECTORY}/${IMAGE_SYMBOL}.cpp")
+
+        add_custom_command(
+            OUTPUT  "${IMAGE_SOURCE}"
+            COMMAND LibPreprocessor::libpreprocessor_embed "${TEMPLATE}" "${IMAGE_SOURCE}" ${IMAGE_SYMBOL} ${ARGS_NAMESPACE}
+            DEPENDS LibPreprocessor::libpreprocessor_embed "${TEMPLATE}"
+            COMMENT "Embedding ${TEMPLATE_NAME} into ${TARGET}"
+            VERBATIM
+        )
+
+        target_sources(${TARGET} PRIVATE "${IMAGE_SOURCE}")
+
+        string(APPEND IMAGE_DECLARATIONS "extern std::string_view const ${IMAGE_SYMBOL};\n")
+        string(APPEND IMAGE_ENTRIES "        { \"${TEMPLATE_NAME}\", ${IMAGE_SYMBOL} },\n")
+        math(EXPR IMAGE_INDEX "${IMAGE_INDEX} + 1")
+    endforeach()
+
+    # the list only changes with `FILES`, so it's written while configuring and left alone when a template changes.
+    string(CONCAT HEADER_CONTENT
+        "// generated by libpreprocessor_embed_templates, don't edit.\n"
+        "\n"
+        "#pragma once\n"
+        "\n"
+        "#include <libpreprocessor/TemplateImage.hpp>\n"
+        "\n"
+        "#include <span>\n"
+        "\n"
+        "@NAMESPACE_BEGIN@"
+        "std::span<libpreprocessor::EmbeddedTemplate const> @ARGS_FUNCTION@();\n"
+        "@NAMESPACE_END@"
+    )
+
+    string(CONCAT SOURCE_CONTENT
+        "// generated by libpreprocessor_embed_templates, don't edit.\n"
+        "\n"
+        "#include \"@ARGS_FUNCTION@.hpp\"\n"
+        "\n"
+        "#include <string_view>\n"
+        "\n"
+        "@NAMESPACE_BEGIN@"
+        "@IMAGE_DECLARATIONS@"
+        "\n"
+        "std::span<libpreprocessor::EmbeddedTemplate const> @ARGS_FUNCTION@()\n"
+        "{\n"
+        "    static libpreprocessor::EmbeddedTemplate const templates[] {\n"
+        "@IMAGE_ENTRIES@"
+        "    };\n"
+        "\n"
+        "    return templates;\n"
+        "}\n"
+        "@NAMESPACE_END@"
+    )
+
+    file(CONFIGURE OUTPUT "${GENERATED_DIRECTORY}/${ARGS_FUNCTION}.hpp" CONTENT "${HEADER_CONTENT}" @ONLY)
+    file(CONFIGURE OUTPUT "${GENERATED_DIRECTORY}/${ARGS_FUNCTION}.cpp" CONTENT "${SOURCE_CONTENT}" @ONLY)
+
+    target_sources(${TARGET} PRIVATE "${GENERATED_DIRECTORY}/${ARGS_FUNCTION}.hpp" "${GENERATED_DIRECTORY}/${ARGS_FUNCTION}.cpp")
+    target_include_directories(${TARGET} PRIVATE "${CMAKE_CURRENT_BINARY_DIR}")
+
+endfunction()
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/Processor.hpp>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+static constexpr auto source_g =
+    "%IF [<|ENV:TENANT|> CONTAINS <premium>]:\n"
+    "    premium!\n"
+    "%ELSE:\n"
+    "    %IF [NOT <|ENV:ENABLED|>]:\n"
+    "        disabled!\n"
+    "    %ELSE:\n"
+    "        standard!\n"
+    "    %END\n"
+    "%END\n";
+
+static std::vector<libpreprocessor::PreprocessorContext> make_contexts(size_t count)
+{
+    std::vector<libpreprocessor::PreprocessorContext> contexts {};
+
+    for (auto index = 0zu; index < count; index += 1)
+    {
+        contexts.push_back({
+            .environmentVariables = {
+                { "ENV:TENANT", index % 3 == 0 ? "premium-" + std::to_string(index) : "tenant-" + std::to_string(index) },
+                { "ENV:ENABLED", index % 2 == 0 ? "TRUE" : "FALSE" }
+            }
+        });
+    }
+
+    return contexts;
+}
+
+TEST(batch_render, matches_process)
+{
+    using namespace std::literals;
+
+    auto const contexts = make_contexts(64);
+
+    for (auto const threads : { 1zu, 4zu })
+    {
+        auto const results = libpreprocessor::process_batch(source_g, contexts, { .threads = threads });
+        EXPECT_EQ(!results.has_value(), false);
+        EXPECT_EQ(results.value().size(), contexts.size());
+
+        for (auto index = 0zu; index < contexts.size(); index += 1)
+        {
+            auto const expected = libpreprocessor::process(std::string_view { source_g }, contexts[index]);
+            EXPECT_EQ(!results.value()[index].has_value(), false);
+            EXPECT_EQ(results.value()[index].value(), expected.value());
+        }
+    }
+}
+
+TEST(batch_render, streamed_outputs)
+{
+    using namespace std::literals;
+
+    auto const contexts = make_contexts(64);
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    std::mutex mutex {};
+    std::vector<std::string> outputs(contexts.size());
+
+    libpreprocessor::interpret_batch(compiled.value(), contexts, [&] (size_t index, auto const& output) {
+        std::scoped_lock lock { mutex };
+        EXPECT_EQ(!output.has_value(), false);
+        EXPECT_EQ(outputs[index].empty(), true);
+        outputs[index] = std::string { output.value() };
+    }, { .threads = 4 });
+
+    for (auto index = 0zu; index < contexts.size(); index += 1)
+    {
+        EXPECT_EQ(outputs[index], libpreprocessor::interpret(compiled.value(), contexts[index]).value());
+    }
+}
+
+TEST(batch_render, failing_item)
+{
+    using namespace std::literals;
+
+    auto contexts = make_contexts(4);
+    contexts[1].environmentVariables.insert_or_assign("ENV:ENABLED", "maybe");
+
+    auto const results = libpreprocessor::process_batch(source_g, contexts);
+    EXPECT_EQ(!results.has_value(), false);
+    EXPECT_EQ(!results.value()[0].has_value(), false);
+    EXPECT_EQ(!results.value()[1].has_value(), true);
+    EXPECT_EQ(!results.value()[2].has_value(), false);
+    EXPECT_STREQ(results.value()[2].value().data(), "        standard!\n");
+}
+
+TEST(batch_render, empty_batch)
+{
+    auto const results = libpreprocessor::process_batch(source_g, {}, { .threads = 0 });
+    EXPECT_EQ(!results.has_value(), false);
+    EXPECT_EQ(results.value().empty(), true);
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/Interpreter.hpp>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+static constexpr auto source_g =
+    "header\n"
+    "%IF [<|ENV:A|> EQUALS <x>]:\n"
+    "    a is x\n"
+    "    %SWITCH [<|ENV:B|>]:\n"
+    "        %CASE [<y>]:\n"
+    "            b is y\n"
+    "        %END\n"
+    "        %DEFAULT:\n"
+    "            b is not y\n"
+    "        %END\n"
+    "    %END\n"
+    "%ELSE:\n"
+    "    a is not x\n"
+    "%END\n"
+    "%PRINT [<footer reached>]\n"
+    "footer\n";
+
+TEST(chunked_render, matches_interpret)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    for (auto const& [a, b] : { std::pair { "x", "y" }, std::pair { "x", "z" }, std::pair { "w", "y" } })
+    {
+        libpreprocessor::PreprocessorContext context {
+            .environmentVariables = {
+                { "ENV:A", a },
+                { "ENV:B", b }
+            },
+            .print = { .type = libpreprocessor::PrintSink::Type::DISCARD }
+        };
+
+        std::string output {};
+        auto chunks = 0zu;
+
+        for (auto const& chunk : libpreprocessor::interpret_chunks(compiled.value(), context))
+        {
+            EXPECT_EQ(!chunk.has_value(), false);
+            output += chunk.value();
+            chunks += 1;
+        }
+
+        EXPECT_EQ(output, libpreprocessor::interpret(compiled.value(), context).value());
+        EXPECT_GT(chunks, 1zu);
+    }
+}
+
+TEST(chunked_render, stops_early)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    std::vector<std::string> printed {};
+
+    libpreprocessor::PreprocessorContext context {
+        .environmentVariables = {
+            { "ENV:A", "x" },
+            { "ENV:B", "y" }
+        },
+        .print = {
+            .type = libpreprocessor::PrintSink::Type::CALLBACK,
+            .callback = [&printed] (std::string_view line) { printed.emplace_back(line); }
+        }
+    };
+
+    std::string output {};
+
+    for (auto const& chunk : libpreprocessor::interpret_chunks(compiled.value(), context))
+    {
+        output += chunk.value();
+        if (output.size() >= 6) break;
+    }
+
+    EXPECT_EQ(output, "header");
+    EXPECT_EQ(printed.empty(), true);
+}
+
+TEST(chunked_render, error_is_the_last_chunk)
+{
+    using namespace std::literals;
+
+    auto const compiled = libpreprocessor::compile("before\n%IF [NOT <|ENV:WORD|>]:\n    hello!\n%END\nafter\n"sv);
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    libpreprocessor::PreprocessorContext context {
+        .environmentVariables = {
+            { "ENV:WORD", "maybe" }
+        }
+    };
+
+    std::vector<bool> succeeded {};
+
+    for (auto const& chunk : libpreprocessor::interpret_chunks(compiled.value(), context))
+    {
+        succeeded.push_back(chunk.has_value());
+    }
+
+    EXPECT_GT(succeeded.size(), 1zu);
+    EXPECT_EQ(std::ranges::count(succeeded, false), 1);
+    EXPECT_EQ(succeeded.back(), false);
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/CodeGenerator.hpp>
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/Interpreter.hpp>
+
+#include <libpreprocessor_generated/render_generated.hpp>
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct Rendered
+{
+    std::optional<std::string> output {};
+    std::string error {};
+    std::vector<std::string> lines {};
+};
+
+// renders through `fnRender` with a context whose printed lines are collected.
+template <typename Render>
+static Rendered render_with(libpreprocessor::PreprocessorContext context, Render const& fnRender)
+{
+    Rendered result {};
+
+    context.print = {
+        .type = libpreprocessor::PrintSink::Type::CALLBACK,
+        .callback = [&result] (std::string_view line) { result.lines.emplace_back(line); }
+    };
+
+    auto const output = fnRender(context);
+    if (output.has_value()) result.output = output.value();
+    else                    result.error = output.error().message();
+
+    return result;
+}
+
+static void expect_same_render(libpreprocessor::PreprocessorContext const& context)
+{
+    auto const compiled = libpreprocessor::compile(std::filesystem::path { TEMPLATE_PATH });
+    ASSERT_EQ(!compiled.has_value(), false);
+
+    auto const interpreted = render_with(context, [&compiled] (auto const& renderContext) { return libpreprocessor::interpret(compiled.value(), renderContext); });
+    auto const generated = render_with(context, [] (auto const& renderContext) { return generated::render_generated(renderContext); });
+
+    EXPECT_EQ(interpreted.output, generated.output);
+    EXPECT_EQ(interpreted.error, generated.error);
+    EXPECT_EQ(interpreted.lines, generated.lines);
+}
+
+TEST(code_generation, matches_interpret)
+{
+    expect_same_render({
+        .environmentVariables = {
+            { "ENV:REGION", "eu" }, { "ENV:TENANT", "premium-1" }, { "ENV:ENABLED", "TRUE" },
+            { "ENV:DEBUG", "FALSE" }, { "ENV:A", "x" }, { "ENV:B", "x" }
+        }
+    });
+
+    expect_same_render({
+        .environmentVariables = {
+            { "ENV:REGION", "home" }, { "ENV:HOME", "home" }, { "ENV:TENANT", "other" }, { "ENV:ENABLED", "TRUE" },
+            { "ENV:DEBUG", "0" }, { "ENV:A", "ab" }, { "ENV:B", "b" }
+        }
+    });
+
+    expect_same_render({
+        .environmentVariables = {
+            { "ENV:REGION", "us" }, { "ENV:TENANT", "premium" }, { "ENV:ENABLED", "FALSE" },
+            { "ENV:DEBUG", "1" }, { "ENV:A", "a" }, { "ENV:B", "c" }
+        }
+    });
+}
+
+TEST(code_generation, matches_interpret_errors)
+{
+    // ENV:DEBUG is left undefined, so NOT is given a literal that doesn't decay.
+    expect_same_render({ .environmentVariables = { { "ENV:REGION", "apac" } } });
+}
+
+TEST(code_generation, matches_interpret_with_provider)
+{
+    expect_same_render({
+        .environmentVariables = { { "ENV:REGION", "eu" } },
+        .provider = [] (std::string_view name) -> std::optional<std::string> {
+            if (name == "ENV:DEBUG") return "TRUE";
+            if (name == "ENV:TENANT") return "premium-provided";
+            return std::nullopt;
+        }
+    });
+}
+
+TEST(code_generation, generated_source)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { "%IF [<|ENV:A|> EQUALS <x>]:\n    a is \"x\"\n%END\nafter\n" });
+    ASSERT_EQ(!compiled.has_value(), false);
+
+    auto const code = libpreprocessor::generate_cpp(compiled.value(), { .functionName = "render_a", .namespaceName = "templates" });
+    ASSERT_EQ(!code.has_value(), false);
+
+    EXPECT_EQ(code.value().contains("namespace templates {"), true);
+    EXPECT_EQ(code.value().contains("inline liberror::Result<void> render_a(libpreprocessor::PreprocessorContext const& context, std::string& output)"), true);
+    EXPECT_EQ(code.value().contains("(std::string_view { render.value(0) } == \"x\"sv)"), true);
+    EXPECT_EQ(code.value().contains("output.append(\"    a is \\\"x\\\"\\n\", 13);"), true);
+    EXPECT_EQ(code.value().contains("output.append(\"after\\n\", 6);"), true);
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/Interpreter.hpp>
+#include <libpreprocessor/Lexer.hpp>
+#include <libpreprocessor/Parser.hpp>
+
+#include <string>
+#include <vector>
+
+TEST(compiled_template, symbol_table)
+{
+    using namespace std::literals;
+
+    auto static constexpr source =
+        "%IF [[<|ENV:A|> EQUALS <|ENV:B|>] OR [<|ENV:A|-|ENV:C|> EQUALS <x>]]:\n"
+        "    hello!\n"
+        "%END\n"sv;
+
+    auto const compiled = libpreprocessor::compile(source);
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    auto const& symbols = compiled.value().symbols;
+    EXPECT_EQ(symbols.size(), 3zu);
+    EXPECT_EQ(symbols.find("ENV:A"), 0zu);
+    EXPECT_EQ(symbols.find("ENV:B"), 1zu);
+    EXPECT_EQ(symbols.find("ENV:C"), 2zu);
+    EXPECT_EQ(symbols.find("ENV:D"), std::nullopt);
+}
+
+TEST(compiled_template, multiple_contexts)
+{
+    using namespace std::literals;
+
+    auto static constexpr source =
+        "%IF [<|ENV:A|-|ENV:B|> EQUALS <x-y>]:\n"
+        "    hello!\n"
+        "%ELSE:\n"
+        "    how are you?\n"
+        "%END\n"sv;
+
+    auto const compiled = libpreprocessor::compile(source);
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    {
+    libpreprocessor::PreprocessorContext context {
+        .environmentVariables = {
+            { "ENV:A", "x" },
+            { "ENV:B", "y" }
+        }
+    };
+
+    auto const result = libpreprocessor::interpret(compiled.value(), context);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "    hello!\n");
+    }
+    {
+    libpreprocessor::PreprocessorContext context {
+        .environmentVariables = {
+            { "ENV:A", "x" },
+            { "ENV:B", "z" }
+        }
+    };
+
+    auto const result = libpreprocessor::interpret(compiled.value(), context);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "    how are you?\n");
+    }
+}
+
+TEST(compiled_template, unknown_variable)
+{
+    using namespace std::literals;
+
+    libpreprocessor::PreprocessorContext context {};
+
+    auto static constexpr source =
+        "%IF [<|ENV:A|> EQUALS <ENV:A>]:\n"
+        "    hello!\n"
+        "%END\n"sv;
+
+    auto const compiled = libpreprocessor::compile(source);
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    auto const result = libpreprocessor::interpret(compiled.value(), context);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "    hello!\n");
+}
+
+TEST(compiled_template, unterminated_variable)
+{
+    using namespace std::literals;
+
+    libpreprocessor::PreprocessorContext context {
+        .environmentVariables = {
+            { "ENV:A", "x" }
+        }
+    };
+
+    auto static constexpr source =
+        "%IF [<|ENV:A|-|ENV:A> EQUALS <x-|ENV:A>]:\n"
+        "    hello!\n"
+        "%END\n"sv;
+
+    auto const compiled = libpreprocessor::compile(source);
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    auto const result = libpreprocessor::interpret(compiled.value(), context);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "    hello!\n");
+}
+
+TEST(compiled_template, output_size)
+{
+    using namespace std::literals;
+
+    auto static constexpr source =
+        "header\n"
+        "%IF [<|ENV:A|> EQUALS <x>]:\n"
+        "    a is x\n"
+        "%END\n"sv;
+
+    auto const compiled = libpreprocessor::compile(source);
+    EXPECT_EQ(!compiled.has_value(), false);
+    EXPECT_EQ(compiled.value().contentBytes, "header\n    a is x\n"sv.size());
+    EXPECT_EQ(compiled.value().lastOutputSize.load(), 0zu);
+
+    libpreprocessor::RenderScratch scratch {};
+
+    auto const taken = libpreprocessor::interpret(compiled.value(), { .environmentVariables = { { "ENV:A", "x" } } }, scratch);
+    EXPECT_EQ(!taken.has_value(), false);
+    EXPECT_EQ(compiled.value().lastOutputSize.load(), taken.value().size());
+    EXPECT_GE(scratch.output.capacity(), compiled.value().contentBytes);
+
+    auto const skipped = libpreprocessor::interpret(compiled.value(), { .environmentVariables = { { "ENV:A", "y" } } });
+    EXPECT_EQ(!skipped.has_value(), false);
+    EXPECT_STREQ(skipped.value().data(), "header\n");
+    EXPECT_EQ(compiled.value().lastOutputSize.load(), 7zu);
+}
+
+TEST(compiled_template, uncompiled_interpolation)
+{
+    using namespace std::literals;
+
+    std::vector<std::string> lines {};
+
+    libpreprocessor::PreprocessorContext context {
+        .environmentVariables = {
+            { "ENV:A", "x" },
+            { "ENV:B", "y" }
+        },
+        .print = {
+            .type = libpreprocessor::PrintSink::Type::CALLBACK,
+            .callback = [&lines] (std::string_view line) { lines.emplace_back(line); }
+        }
+    };
+
+    auto static constexpr source =
+        "%PRINT [<|ENV:A|-|ENV:B|-|ENV:C|>]\n"
+        "%PRINT [<|ENV:A||ENV:B|>]\n"
+        "%PRINT [<x-|ENV:A|-|ENV:B>]\n"sv;
+
+    std::vector<std::string> const expected { "x-y-ENV:C", "xy", "x-x-|ENV:B" };
+
+    libpreprocessor::Lexer lexer { source };
+    libpreprocessor::Parser parser { lexer.tokenize() };
+    auto const head = parser.parse();
+    EXPECT_EQ(!head.has_value(), false);
+
+    auto const uncompiled = libpreprocessor::interpret(head.value(), context);
+    EXPECT_EQ(!uncompiled.has_value(), false);
+    EXPECT_EQ(lines, expected);
+
+    lines.clear();
+
+    auto const compiled = libpreprocessor::compile(source);
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    auto const result = libpreprocessor::interpret(compiled.value(), context);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_EQ(lines, expected);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/Interpreter.hpp>
+
+#include <array>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr auto source_g =
+    "%SWITCH [<|ENV:REGION|>]:\n"
+    "    %CASE [<eu>]:\n"
+    "        region eu\n"
+    "    %END\n"
+    "    %CASE [<us>]:\n"
+    "        region us\n"
+    "    %END\n"
+    "    %DEFAULT:\n"
+    "        region unknown\n"
+    "    %END\n"
+    "%END\n"
+    "%IF [[<|ENV:TENANT|> CONTAINS <premium>] AND <|ENV:ENABLED|>]:\n"
+    "    premium!\n"
+    "%ELSE:\n"
+    "    standard!\n"
+    "%END\n";
+
+static libpreprocessor::PreprocessorContext make_context(size_t index)
+{
+    std::array<char const*, 3> static constexpr regions { "eu", "us", "apac" };
+
+    return {
+        .environmentVariables = {
+            { "ENV:REGION", regions[index % regions.size()] },
+            { "ENV:TENANT", index % 3 == 0 ? "premium-" + std::to_string(index) : "tenant-" + std::to_string(index) },
+            { "ENV:ENABLED", index % 2 == 0 ? "TRUE" : "FALSE" }
+        }
+    };
+}
+
+TEST(concurrent_render, shared_template)
+{
+    auto static constexpr threadCount = 8zu;
+    auto static constexpr rendersPerThread = 500zu;
+
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    std::vector<libpreprocessor::PreprocessorContext> contexts {};
+    std::vector<std::string> expected {};
+
+    for (auto index = 0zu; index < 16; index += 1)
+    {
+        contexts.push_back(make_context(index));
+        expected.push_back(libpreprocessor::interpret(compiled.value(), contexts.back()).value());
+    }
+
+    std::vector<size_t> mismatches(threadCount);
+
+    {
+    std::vector<std::jthread> threads {};
+
+    for (auto thread = 0zu; thread < threadCount; thread += 1)
+    {
+        threads.emplace_back([&, thread] {
+            libpreprocessor::RenderScratch scratch {};
+
+            for (auto render = 0zu; render < rendersPerThread; render += 1)
+            {
+                auto const index = (thread + render) % contexts.size();
+                auto const result = libpreprocessor::interpret(compiled.value(), contexts[index], scratch);
+                if (!result.has_value() || result.value() != expected[index]) mismatches[thread] += 1;
+            }
+        });
+    }
+    }
+
+    for (auto const count : mismatches)
+    {
+        EXPECT_EQ(count, 0zu);
+    }
+}
+
+TEST(concurrent_render, reused_scratch)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    libpreprocessor::RenderScratch scratch {};
+
+    {
+    auto const result = libpreprocessor::interpret(compiled.value(), make_context(0), scratch);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_EQ(result.value(), "        region eu\n    premium!\n");
+    }
+    {
+    auto const result = libpreprocessor::interpret(compiled.value(), make_context(5), scratch);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_EQ(result.value(), "        region unknown\n    standard!\n");
+    }
+}
+
+TEST(concurrent_render, copied_contexts)
+{
+    auto static constexpr threadCount = 8zu;
+
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    // every thread renders its own copy of the context, all of them sharing the bytes of its values.
+    auto const context = make_context(0);
+    auto const expected = libpreprocessor::interpret(compiled.value(), context).value();
+
+    std::vector<size_t> mismatches(threadCount);
+
+    {
+    std::vector<std::jthread> threads {};
+
+    for (auto thread = 0zu; thread < threadCount; thread += 1)
+    {
+        threads.emplace_back([&, thread, copy = context] {
+            if (copy.find_variable("ENV:TENANT")->data() != context.find_variable("ENV:TENANT")->data()) mismatches[thread] += 1;
+
+            libpreprocessor::RenderScratch scratch {};
+
+            for (auto render = 0zu; render < 100; render += 1)
+            {
+                auto const result = libpreprocessor::interpret(compiled.value(), copy, scratch);
+                if (!result.has_value() || result.value() != expected) mismatches[thread] += 1;
+            }
+        });
+    }
+    }
+
+    for (auto const count : mismatches)
+    {
+        EXPECT_EQ(count, 0zu);
+    }
+}
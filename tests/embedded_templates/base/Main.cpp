@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/Interpreter.hpp>
+#include <libpreprocessor/TemplateImage.hpp>
+
+#include <libpreprocessor_generated/embedded_templates.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+static libpreprocessor::PreprocessorContext make_context(std::string name, std::string debug, std::vector<std::string>& printed)
+{
+    return {
+        .environmentVariables = { { "ENV:LANGUAGE", "pt" }, { "ENV:NAME", std::move(name) }, { "ENV:DEBUG", std::move(debug) } },
+        .print = {
+            .type = libpreprocessor::PrintSink::Type::CALLBACK,
+            .callback = [&printed] (std::string_view line) { printed.emplace_back(line); }
+        }
+    };
+}
+
+TEST(embedded_templates, listed_by_relative_path)
+{
+    auto const templates = embedded::embedded_templates();
+
+    EXPECT_EQ(templates.size(), 2zu);
+    EXPECT_EQ(templates[0].name, "Greeting.txt");
+    EXPECT_EQ(templates[1].name, "templates/Footer.txt");
+}
+
+TEST(embedded_templates, renders_like_the_file)
+{
+    for (auto const& embedded : embedded::embedded_templates())
+    {
+        auto const loaded = libpreprocessor::load_embedded(embedded::embedded_templates(), embedded.name);
+        auto const compiled = libpreprocessor::compile(std::filesystem::path { TEMPLATE_DIRECTORY } / embedded.name);
+        ASSERT_EQ(!loaded.has_value(), false);
+        ASSERT_EQ(!compiled.has_value(), false);
+
+        EXPECT_EQ(loaded.value().symbols.names(), compiled.value().symbols.names());
+        EXPECT_EQ(loaded.value().prints, compiled.value().prints);
+        EXPECT_EQ(loaded.value().contentBytes, compiled.value().contentBytes);
+
+        for (auto const& [name, debug] : { std::pair { "admin", "FALSE" }, std::pair { "guest", "TRUE" }, std::pair { "guest", "FALSE" } })
+        {
+            std::vector<std::string> loadedPrinted {};
+            std::vector<std::string> compiledPrinted {};
+
+            auto const expected = libpreprocessor::interpret(compiled.value(), make_context(name, debug, compiledPrinted));
+            auto const result = libpreprocessor::interpret(loaded.value(), make_context(name, debug, loadedPrinted));
+
+            EXPECT_EQ(!result.has_value(), false);
+            EXPECT_EQ(result.value(), expected.value());
+            EXPECT_EQ(loadedPrinted, compiledPrinted);
+        }
+    }
+}
+
+TEST(embedded_templates, unknown_name)
+{
+    auto const loaded = libpreprocessor::load_embedded(embedded::embedded_templates(), "Missing.txt");
+    EXPECT_EQ(!loaded.has_value(), true);
+}
+
+TEST(embedded_templates, image_round_trip)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { "%IF [<|ENV:A|> EQUALS <a>]:\n    a\n%ELSE:\n    b\n%END\n" });
+    ASSERT_EQ(!compiled.has_value(), false);
+
+    auto const image = libpreprocessor::save_image(compiled.value());
+    ASSERT_EQ(!image.has_value(), false);
+
+    auto const loaded = libpreprocessor::load_image(image.value());
+    ASSERT_EQ(!loaded.has_value(), false);
+    EXPECT_NE(loaded.value().id, compiled.value().id);
+
+    libpreprocessor::PreprocessorContext const context { .environmentVariables = { { "ENV:A", "a" } } };
+    EXPECT_EQ(libpreprocessor::interpret(loaded.value(), context).value(), libpreprocessor::interpret(compiled.value(), context).value());
+
+    auto const saved = libpreprocessor::save_image(loaded.value());
+    ASSERT_EQ(!saved.has_value(), false);
+    EXPECT_EQ(saved.value(), image.value());
+}
+
+TEST(embedded_templates, malformed_images)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { "%PRINT [<|ENV:A|>]\nhello\n" });
+    ASSERT_EQ(!compiled.has_value(), false);
+
+    auto const image = libpreprocessor::save_image(compiled.value());
+    ASSERT_EQ(!image.has_value(), false);
+
+    for (auto size = 0zu; size < image.value().size(); size += 1)
+    {
+        EXPECT_EQ(!libpreprocessor::load_image(std::string_view { image.value() }.substr(0, size)).has_value(), true);
+    }
+
+    EXPECT_EQ(!libpreprocessor::load_image(image.value() + "x").has_value(), true);
+    EXPECT_EQ(!libpreprocessor::load_image("XXXX" + image.value().substr(4)).has_value(), true);
+}
@@ -50,6 +50,45 @@ TEST(true_if_statement_with_complex_expression_using_the_preprocessor_context, s
     }
 }
 
+TEST(true_if_statement_with_short_circuited_expression, single)
+{
+    using namespace std::literals;
+
+    libpreprocessor::PreprocessorContext context {};
+
+    {
+    auto static constexpr source =
+        "%IF [<TRUE> OR [NOT <maybe>]]:\n"
+        "    hello!\n"
+        "%END\n"sv;
+
+    auto const result = libpreprocessor::process(source, context);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "    hello!\n");
+    }
+    {
+    auto static constexpr source =
+        "%IF [<FALSE> AND [NOT <maybe>]]:\n"
+        "    hello!\n"
+        "%ELSE:\n"
+        "    how are you?\n"
+        "%END\n"sv;
+
+    auto const result = libpreprocessor::process(source, context);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "    how are you?\n");
+    }
+    {
+    auto static constexpr source =
+        "%IF [<FALSE> OR [NOT <maybe>]]:\n"
+        "    hello!\n"
+        "%END\n"sv;
+
+    auto const result = libpreprocessor::process(source, context);
+    EXPECT_EQ(!result.has_value(), true);
+    }
+}
+
 TEST(true_if_statement, single_justified)
 {
     using namespace std::literals;
@@ -502,3 +541,46 @@ TEST(surrounded_multiple_true_nested_if_statement, single)
     EXPECT_STREQ(result.value().data(), "hello!\n    hello!\n        hello!\n    hello!\nhello!\n    hello!\n        hello!\n    hello!\nhello!\n");
 }
 
+
+TEST(if_statement, true_if_statement_with_integer_decay)
+{
+    using namespace std::literals;
+
+    libpreprocessor::PreprocessorContext context {
+        .environmentVariables = {
+            { "ENV:ZERO", "0" },
+            { "ENV:SIGNED", "+7" },
+            { "ENV:SUFFIXED", "12px" }
+        }
+    };
+
+    auto static constexpr source =
+        "%IF [[[NOT <0>] AND [NOT [NOT <12>]]] AND [[NOT <|ENV:ZERO|>] AND [NOT [NOT <|ENV:SIGNED|>]]]]:\n"
+        "    %IF [NOT [NOT <|ENV:SUFFIXED|>]]:\n"
+        "        hello!\n"
+        "    %END\n"
+        "%END\n"sv;
+
+    auto const result = libpreprocessor::process(source, context);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "        hello!\n");
+}
+
+TEST(if_statement, if_statement_with_undecayable_variable)
+{
+    using namespace std::literals;
+
+    libpreprocessor::PreprocessorContext context {
+        .environmentVariables = {
+            { "ENV:WORD", "maybe" }
+        }
+    };
+
+    auto static constexpr source =
+        "%IF [NOT <|ENV:WORD|>]:\n"
+        "    hello!\n"
+        "%END\n"sv;
+
+    auto const result = libpreprocessor::process(source, context);
+    EXPECT_EQ(!result.has_value(), true);
+}
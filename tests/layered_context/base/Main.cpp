@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/Interpreter.hpp>
+#include <libpreprocessor/Processor.hpp>
+#include <libpreprocessor/RenderCache.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+static constexpr auto source_g =
+    "%IF [<|ENV:A|> EQUALS <x>]:\n"
+    "    a is x\n"
+    "%END\n"
+    "%IF [<|ENV:B|> EQUALS <y>]:\n"
+    "    b is y\n"
+    "%END\n";
+
+TEST(layered_context, overrides)
+{
+    using namespace std::literals;
+
+    auto const base = std::make_shared<libpreprocessor::VariableMap const>(libpreprocessor::VariableMap {
+        { "ENV:A", "x" },
+        { "ENV:B", "y" }
+    });
+
+    libpreprocessor::PreprocessorContext const inherited { .baseVariables = base };
+    libpreprocessor::PreprocessorContext const overridden { .environmentVariables = { { "ENV:A", "z" } }, .baseVariables = base };
+
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    auto const first = libpreprocessor::interpret(compiled.value(), inherited);
+    EXPECT_EQ(!first.has_value(), false);
+    EXPECT_STREQ(first.value().data(), "    a is x\n    b is y\n");
+
+    auto const second = libpreprocessor::interpret(compiled.value(), overridden);
+    EXPECT_EQ(!second.has_value(), false);
+    EXPECT_STREQ(second.value().data(), "    b is y\n");
+
+    EXPECT_EQ(*inherited.find_variable("ENV:A"), "x"sv);
+    EXPECT_EQ(*overridden.find_variable("ENV:A"), "z"sv);
+    EXPECT_EQ(overridden.find_variable("ENV:C"), nullptr);
+    EXPECT_EQ(base->size(), 2zu);
+}
+
+TEST(layered_context, print_interpolation)
+{
+    std::vector<std::string> lines {};
+
+    libpreprocessor::PreprocessorContext const context {
+        .environmentVariables = { { "ENV:B", "b" } },
+        .print = {
+            .type = libpreprocessor::PrintSink::Type::CALLBACK,
+            .callback = [&lines] (std::string_view line) { lines.emplace_back(line); }
+        },
+        .baseVariables = std::make_shared<libpreprocessor::VariableMap const>(libpreprocessor::VariableMap {
+            { "ENV:A", "a" },
+            { "ENV:B", "base" }
+        })
+    };
+
+    auto const result = libpreprocessor::process(std::string_view { "%PRINT [<|ENV:A|-|ENV:B|-|ENV:C|>]\n" }, context);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_EQ(lines, (std::vector<std::string> { "a-b-ENV:C" }));
+}
+
+TEST(layered_context, session_and_cache)
+{
+    libpreprocessor::PreprocessorContext const context {
+        .baseVariables = std::make_shared<libpreprocessor::VariableMap const>(libpreprocessor::VariableMap {
+            { "ENV:A", "x" },
+            { "ENV:B", "y" }
+        })
+    };
+
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    libpreprocessor::RenderSession session { compiled.value(), context };
+    EXPECT_STREQ(session.render().value().data(), "    a is x\n    b is y\n");
+    EXPECT_STREQ(session.update("ENV:B", "y").value().data(), "    a is x\n    b is y\n");
+    EXPECT_STREQ(session.update("ENV:B", "n").value().data(), "    a is x\n");
+    EXPECT_EQ(context.baseVariables->find("ENV:B")->second, "y");
+
+    libpreprocessor::RenderCache cache {};
+    libpreprocessor::PreprocessorContext overridden = context;
+    overridden.environmentVariables.insert("ENV:B", "n");
+
+    EXPECT_STREQ(cache.render(compiled.value(), context).value().data(), "    a is x\n    b is y\n");
+    EXPECT_STREQ(cache.render(compiled.value(), overridden).value().data(), "    a is x\n");
+    EXPECT_EQ(cache.statistics().misses, 2zu);
+}
@@ -1,9 +1,14 @@
 #include <gtest/gtest.h>
 
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/Interpreter.hpp>
 #include <libpreprocessor/Processor.hpp>
 
 #include <stdio.h>
 #include <array>
+#include <span>
+#include <string>
+#include <vector>
 
 static constexpr auto BUFFER_SIZE = 1024;
 
@@ -202,3 +207,112 @@ TEST(print_statement, multiple_interpolated_string_with_all_ignored)
     EXPECT_STREQ(buffer.data(), "ENV:TEST is ENV:TEST\n");
 }
 
+
+TEST(print_statement, discarded)
+{
+    using namespace std::literals;
+
+    libpreprocessor::PreprocessorContext context {
+        .print = { .type = libpreprocessor::PrintSink::Type::DISCARD }
+    };
+
+    auto static constexpr source = "%PRINT [<hello!>]\n"sv;
+
+    std::array<char, BUFFER_SIZE> buffer {};
+    auto const previousState = redirect_stdout_to_buffer(buffer);
+    auto const result = libpreprocessor::process(source, context);
+    restore_stdout(previousState);
+
+    EXPECT_EQ(!result.has_value(), false);
+
+    EXPECT_STREQ(buffer.data(), "");
+}
+
+TEST(print_statement, buffered)
+{
+    using namespace std::literals;
+
+    libpreprocessor::PreprocessorContext context {
+        .environmentVariables = {
+            { "ENV:TEST", "TESTING" }
+        },
+        .print = { .type = libpreprocessor::PrintSink::Type::BUFFER }
+    };
+
+    auto static constexpr source =
+        "%PRINT [<hello!>]\n"
+        "content\n"
+        "%PRINT [<ENV:TEST is |ENV:TEST|>]\n"sv;
+
+    auto const compiled = libpreprocessor::compile(source);
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    libpreprocessor::RenderScratch scratch {};
+
+    std::array<char, BUFFER_SIZE> buffer {};
+    auto const previousState = redirect_stdout_to_buffer(buffer);
+    auto const result = libpreprocessor::interpret(compiled.value(), context, scratch);
+    restore_stdout(previousState);
+
+    EXPECT_EQ(!result.has_value(), false);
+
+    EXPECT_STREQ(buffer.data(), "");
+    EXPECT_EQ(result.value(), "content\n");
+    EXPECT_EQ(scratch.printed, (std::vector<std::string> { "hello!", "ENV:TEST is TESTING" }));
+}
+
+TEST(print_statement, buffered_only_into_a_scratch)
+{
+    using namespace std::literals;
+
+    libpreprocessor::PreprocessorContext const context {
+        .print = { .type = libpreprocessor::PrintSink::Type::BUFFER }
+    };
+
+    auto static constexpr source = "%PRINT [<hello!>]\ncontent\n"sv;
+
+    auto const compiled = libpreprocessor::compile(source);
+    ASSERT_EQ(!compiled.has_value(), false);
+
+    // none of these have anywhere to return the lines, so they fail rather than lose them.
+    EXPECT_EQ(!libpreprocessor::process(source, context).has_value(), true);
+    EXPECT_EQ(!libpreprocessor::interpret(compiled.value(), context).has_value(), true);
+
+    auto const batch = libpreprocessor::interpret_batch(compiled.value(), std::span { &context, 1 });
+    EXPECT_EQ(!batch.front().has_value(), true);
+
+    for (auto const& piece : libpreprocessor::interpret_chunks(compiled.value(), context))
+    {
+        EXPECT_EQ(!piece.has_value(), true);
+    }
+
+    libpreprocessor::RenderSession session { compiled.value(), context };
+    EXPECT_EQ(!session.render().has_value(), true);
+}
+
+TEST(print_statement, callback)
+{
+    using namespace std::literals;
+
+    std::vector<std::string> lines {};
+
+    libpreprocessor::PreprocessorContext context {
+        .environmentVariables = {
+            { "ENV:TEST", "TESTING" }
+        },
+        .print = {
+            .type = libpreprocessor::PrintSink::Type::CALLBACK,
+            .callback = [&lines] (std::string_view line) { lines.emplace_back(line); }
+        }
+    };
+
+    auto static constexpr source =
+        "%PRINT [<hello!>]\n"
+        "%PRINT [<ENV:TEST is |ENV:TEST|>]\n"sv;
+
+    auto const result = libpreprocessor::process(source, context);
+
+    EXPECT_EQ(!result.has_value(), false);
+
+    EXPECT_EQ(lines, (std::vector<std::string> { "hello!", "ENV:TEST is TESTING" }));
+}
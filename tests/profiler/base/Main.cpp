@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/Interpreter.hpp>
+#include <libpreprocessor/Profiler.hpp>
+
+#include <algorithm>
+#include <span>
+#include <string>
+#include <vector>
+
+static constexpr auto source_g =
+    "header\n"
+    "%IF [<|ENV:LIST|> CONTAINS <needle>]:\n"
+    "    %SWITCH [<|ENV:A|>]:\n"
+    "        %CASE [<x>]:\n"
+    "            a is x\n"
+    "        %END\n"
+    "    %END\n"
+    "%END\n";
+
+static libpreprocessor::PreprocessorContext const context_g {
+    .environmentVariables = {
+        { "ENV:LIST", "haystack-needle" },
+        { "ENV:A", "x" }
+    }
+};
+
+TEST(profiler, node_locations)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    auto const& head = compiled.value().head;
+    EXPECT_EQ(head->location.position.first, 1zu);
+    EXPECT_EQ(head->nodes.front()->location.position.first, 2zu);
+}
+
+TEST(profiler, report)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    libpreprocessor::Profiler profiler {};
+
+    for (auto index = 0; index < 3; index += 1)
+    {
+        auto const result = libpreprocessor::interpret(compiled.value(), context_g, profiler);
+        EXPECT_EQ(!result.has_value(), false);
+        EXPECT_STREQ(result.value().data(), "header\n            a is x\n");
+    }
+
+    auto const report = profiler.report();
+    EXPECT_EQ(std::ranges::is_sorted(report, std::ranges::greater {}, &libpreprocessor::Profiler::Entry::inclusive), true);
+
+    auto const fnFind = [&report] (std::string_view kind, size_t line) {
+        return std::ranges::find_if(report, [&] (auto const& entry) { return entry.kind == kind && entry.location.position.first == line; });
+    };
+
+    auto const ifEntry = fnFind("IStatementNode::Type::IF", 2);
+    EXPECT_NE(ifEntry, report.end());
+    EXPECT_EQ(ifEntry->hits, 3zu);
+
+    auto const switchEntry = fnFind("IStatementNode::Type::SWITCH", 3);
+    EXPECT_NE(switchEntry, report.end());
+    EXPECT_EQ(switchEntry->hits, 3zu);
+    EXPECT_LE(switchEntry->inclusive, ifEntry->inclusive);
+
+    EXPECT_NE(fnFind("INode::Type::OPERATOR", 2), report.end());
+    EXPECT_NE(profiler.report_as_string().find("IStatementNode::Type::IF"), std::string::npos);
+}
+
+TEST(profiler, chrome_trace)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    libpreprocessor::Profiler profiler { { .traceEvents = 1024 } };
+    EXPECT_EQ(profiler.chrome_trace(), "{\"traceEvents\":[]}");
+
+    EXPECT_EQ(!libpreprocessor::interpret(compiled.value(), context_g, profiler).has_value(), false);
+
+    auto const trace = profiler.chrome_trace();
+    EXPECT_EQ(trace.starts_with("{\"traceEvents\":[{"), true);
+    EXPECT_EQ(trace.ends_with("}]}"), true);
+    EXPECT_NE(trace.find("\"name\":\"IStatementNode::Type::SWITCH\""), std::string::npos);
+    EXPECT_NE(trace.find("\"line\":3"), std::string::npos);
+
+    profiler.clear();
+    EXPECT_EQ(profiler.report().empty(), true);
+}
+
+TEST(profiler, trace_events_are_bounded)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    // tracing is off unless asked for, which leaves only the per-node report.
+    libpreprocessor::Profiler untraced {};
+    EXPECT_EQ(!libpreprocessor::interpret(compiled.value(), context_g, untraced).has_value(), false);
+    EXPECT_EQ(untraced.chrome_trace(), "{\"traceEvents\":[]}");
+    EXPECT_NE(untraced.dropped_events(), 0zu);
+    EXPECT_EQ(untraced.report().empty(), false);
+
+    libpreprocessor::Profiler traced { { .traceEvents = 4 } };
+
+    for (auto index = 0; index < 100; index += 1)
+        EXPECT_EQ(!libpreprocessor::interpret(compiled.value(), context_g, traced).has_value(), false);
+
+    libpreprocessor::Profiler unbounded { { .traceEvents = 1024 } };
+    EXPECT_EQ(!libpreprocessor::interpret(compiled.value(), context_g, unbounded).has_value(), false);
+
+    auto const fnNames = [] (std::string const& trace) {
+        std::vector<std::string> names {};
+
+        for (auto position = trace.find("\"name\":\""); position != std::string::npos; position = trace.find("\"name\":\"", position + 1))
+        {
+            auto const begin = position + 8;
+            names.push_back(trace.substr(begin, trace.find('"', begin) - begin));
+        }
+
+        return names;
+    };
+
+    // only the latest events are kept, still in the order they were recorded in.
+    auto const names = fnNames(traced.chrome_trace());
+    auto const expected = fnNames(unbounded.chrome_trace());
+
+    EXPECT_EQ(names.size(), 4zu);
+    EXPECT_EQ(std::ranges::equal(names, std::span { expected }.last(4)), true);
+    EXPECT_EQ(traced.dropped_events(), 100 * untraced.dropped_events() - 4);
+
+    traced.clear();
+    EXPECT_EQ(traced.dropped_events(), 0zu);
+}
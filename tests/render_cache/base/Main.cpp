@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/RenderCache.hpp>
+
+#include <optional>
+#include <string>
+
+static constexpr auto source_g =
+    "%IF [<|ENV:TENANT|> CONTAINS <premium>]:\n"
+    "    premium!\n"
+    "%ELSE:\n"
+    "    standard!\n"
+    "%END\n";
+
+TEST(render_cache, unread_variables_hit)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    libpreprocessor::RenderCache cache {};
+
+    for (auto index = 0zu; index < 4; index += 1)
+    {
+        libpreprocessor::PreprocessorContext context {
+            .environmentVariables = {
+                { "ENV:TENANT", "premium-a" },
+                { "ENV:UNRELATED", std::to_string(index) }
+            }
+        };
+
+        auto const result = cache.render(compiled.value(), context);
+        EXPECT_EQ(!result.has_value(), false);
+        EXPECT_STREQ(result.value().data(), "    premium!\n");
+    }
+
+    auto const statistics = cache.statistics();
+    EXPECT_EQ(statistics.misses, 1zu);
+    EXPECT_EQ(statistics.hits, 3zu);
+    EXPECT_EQ(statistics.entries, 1zu);
+}
+
+TEST(render_cache, read_variables_miss)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    libpreprocessor::RenderCache cache {};
+
+    {
+    libpreprocessor::PreprocessorContext context { .environmentVariables = { { "ENV:TENANT", "premium-a" } } };
+    auto const result = cache.render(compiled.value(), context);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "    premium!\n");
+    }
+    {
+    libpreprocessor::PreprocessorContext context { .environmentVariables = { { "ENV:TENANT", "tenant-b" } } };
+    auto const result = cache.render(compiled.value(), context);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "    standard!\n");
+    }
+
+    EXPECT_EQ(cache.statistics().misses, 2zu);
+    EXPECT_EQ(cache.statistics().entries, 2zu);
+}
+
+TEST(render_cache, templates_are_kept_apart)
+{
+    auto const first = libpreprocessor::compile(std::string_view { source_g });
+    auto const second = libpreprocessor::compile(std::string_view { "%IF [<|ENV:TENANT|> CONTAINS <premium>]:\n    other!\n%END\n" });
+    EXPECT_EQ(!first.has_value(), false);
+    EXPECT_EQ(!second.has_value(), false);
+    EXPECT_NE(first.value().id, second.value().id);
+
+    libpreprocessor::RenderCache cache {};
+    libpreprocessor::PreprocessorContext context { .environmentVariables = { { "ENV:TENANT", "premium-a" } } };
+
+    EXPECT_STREQ(cache.render(first.value(), context).value().data(), "    premium!\n");
+    EXPECT_STREQ(cache.render(second.value(), context).value().data(), "    other!\n");
+    EXPECT_EQ(cache.statistics().hits, 0zu);
+}
+
+TEST(render_cache, least_recently_used_eviction)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    libpreprocessor::RenderCache cache { { .capacityBytes = 1024 } };
+
+    for (auto index = 0zu; index < 64; index += 1)
+    {
+        libpreprocessor::PreprocessorContext context { .environmentVariables = { { "ENV:TENANT", "tenant-" + std::to_string(index) } } };
+        EXPECT_EQ(!cache.render(compiled.value(), context).has_value(), false);
+    }
+
+    auto const statistics = cache.statistics();
+    EXPECT_LE(statistics.bytes, 1024zu);
+    EXPECT_GT(statistics.entries, 0zu);
+    EXPECT_LT(statistics.entries, 64zu);
+
+    // the most recent render is still cached, the first one was evicted.
+    libpreprocessor::PreprocessorContext last { .environmentVariables = { { "ENV:TENANT", "tenant-63" } } };
+    libpreprocessor::PreprocessorContext first { .environmentVariables = { { "ENV:TENANT", "tenant-0" } } };
+
+    EXPECT_EQ(!cache.render(compiled.value(), last).has_value(), false);
+    EXPECT_EQ(cache.statistics().hits, 1zu);
+    EXPECT_EQ(!cache.render(compiled.value(), first).has_value(), false);
+    EXPECT_EQ(cache.statistics().hits, 1zu);
+}
+
+TEST(render_cache, printing_templates_are_rendered)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { "%PRINT [<hello!>]\ncontent\n" });
+    EXPECT_EQ(!compiled.has_value(), false);
+    EXPECT_EQ(compiled.value().prints, true);
+
+    libpreprocessor::RenderCache cache {};
+    auto lines = 0zu;
+
+    libpreprocessor::PreprocessorContext context {
+        .print = {
+            .type = libpreprocessor::PrintSink::Type::CALLBACK,
+            .callback = [&lines] (std::string_view) { lines += 1; }
+        }
+    };
+
+    EXPECT_STREQ(cache.render(compiled.value(), context).value().data(), "content\n");
+    EXPECT_STREQ(cache.render(compiled.value(), context).value().data(), "content\n");
+    EXPECT_EQ(lines, 2zu);
+    EXPECT_EQ(cache.statistics().entries, 0zu);
+}
+
+TEST(render_cache, provider_is_asked_once_per_miss)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    libpreprocessor::RenderCache cache {};
+    auto calls = 0zu;
+
+    // answers differently every time it's asked, so a second call during the render would show in the output.
+    libpreprocessor::PreprocessorContext context {
+        .provider = [&calls] (std::string_view) -> std::optional<std::string> {
+            calls += 1;
+            return calls == 1 ? "premium-a" : "tenant-b";
+        }
+    };
+
+    EXPECT_STREQ(cache.render(compiled.value(), context).value().data(), "    premium!\n");
+    EXPECT_EQ(calls, 1zu);
+
+    // asked again for the key, which now matches nothing cached.
+    EXPECT_STREQ(cache.render(compiled.value(), context).value().data(), "    standard!\n");
+    EXPECT_EQ(calls, 2zu);
+    EXPECT_EQ(cache.statistics().misses, 2zu);
+}
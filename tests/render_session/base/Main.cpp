@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/Interpreter.hpp>
+
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+
+// every block prints its name when it's rendered, so the tests can tell which ones were.
+static constexpr auto source_g =
+    "%IF [<|ENV:A|> EQUALS <x>]:\n"
+    "    %PRINT [<a>]\n"
+    "    a is x\n"
+    "%ELSE:\n"
+    "    %PRINT [<a>]\n"
+    "    a is |ENV:A|\n"
+    "%END\n"
+    "between\n"
+    "%SWITCH [<|ENV:B|>]:\n"
+    "    %CASE [<y>]:\n"
+    "        %PRINT [<b>]\n"
+    "        b is y\n"
+    "    %END\n"
+    "    %DEFAULT:\n"
+    "        %PRINT [<b>]\n"
+    "        b is not y\n"
+    "    %END\n"
+    "%END\n"
+    "%IF [[<|ENV:A|> EQUALS <x>] OR [<|ENV:C|> EQUALS <z>]]:\n"
+    "    %PRINT [<c>]\n"
+    "    a is x or c is z\n"
+    "%END\n";
+
+static libpreprocessor::PreprocessorContext make_context(std::vector<std::string>& rendered)
+{
+    return {
+        .environmentVariables = {
+            { "ENV:A", "x" },
+            { "ENV:B", "y" },
+            { "ENV:C", "z" }
+        },
+        .print = {
+            .type = libpreprocessor::PrintSink::Type::CALLBACK,
+            .callback = [&rendered] (std::string_view line) { rendered.emplace_back(line); }
+        }
+    };
+}
+
+TEST(render_session, matches_interpret)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    std::vector<std::string> rendered {};
+    libpreprocessor::RenderSession session { compiled.value(), make_context(rendered) };
+
+    auto const result = session.render();
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_EQ(result.value(), libpreprocessor::interpret(compiled.value(), session.context()).value());
+    EXPECT_EQ(rendered, (std::vector<std::string> { "a", "b", "c", "a", "b", "c" }));
+}
+
+TEST(render_session, only_dependent_blocks)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    std::vector<std::string> rendered {};
+    libpreprocessor::RenderSession session { compiled.value(), make_context(rendered) };
+    EXPECT_EQ(!session.render().has_value(), false);
+
+    {
+    rendered.clear();
+    auto const result = session.update("ENV:B", "w");
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_EQ(result.value(), "    a is x\nbetween\n        b is not y\n    a is x or c is z\n");
+    EXPECT_EQ(rendered, (std::vector<std::string> { "b" }));
+    }
+    {
+    // the last block short-circuited before reading ENV:C.
+    rendered.clear();
+    auto const result = session.update("ENV:C", "w");
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_EQ(rendered, (std::vector<std::string> {}));
+    }
+    {
+    rendered.clear();
+    auto const result = session.update("ENV:A", "q");
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_EQ(result.value(), "    a is |ENV:A|\nbetween\n        b is not y\n");
+    EXPECT_EQ(rendered, (std::vector<std::string> { "a" }));
+    }
+    {
+    rendered.clear();
+    auto const result = session.update("ENV:UNREAD", "q");
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_EQ(rendered, (std::vector<std::string> {}));
+    }
+}
+
+TEST(render_session, randomized_updates)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    std::vector<std::string> rendered {};
+    libpreprocessor::RenderSession session { compiled.value(), make_context(rendered) };
+
+    std::array<char const*, 3> static constexpr names { "ENV:A", "ENV:B", "ENV:C" };
+    std::array<char const*, 5> static constexpr values { "x", "y", "z", "w", "a longer value" };
+
+    std::mt19937 generator { 42 };
+
+    for (auto step = 0; step < 500; step += 1)
+    {
+        auto const result = session.update(names[generator() % names.size()], values[generator() % values.size()]);
+        EXPECT_EQ(!result.has_value(), false);
+        EXPECT_EQ(result.value(), libpreprocessor::interpret(compiled.value(), session.context()).value());
+    }
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/Processor.hpp>
+#include <libpreprocessor/Searcher.hpp>
+
+#include <random>
+#include <string>
+
+TEST(searcher, short_and_long_needles)
+{
+    using namespace std::literals;
+
+    auto const haystack = "the quick brown fox jumps over the lazy dog"sv;
+
+    for (auto const needle : { "t"sv, "dog"sv, "fox"sv, "the lazy dog"sv, "quick brown"sv, "the quick brown fox jumps over the lazy dog"sv })
+    {
+        EXPECT_EQ(libpreprocessor::Searcher { std::string { needle } }.found_in(haystack), true);
+    }
+
+    for (auto const needle : { "x!"sv, "cat"sv, "the lazy cat"sv, "quick  brown"sv, "the quick brown fox jumps over the lazy dog!"sv })
+    {
+        EXPECT_EQ(libpreprocessor::Searcher { std::string { needle } }.found_in(haystack), false);
+    }
+
+    EXPECT_EQ(libpreprocessor::Searcher { "" }.found_in(""), true);
+    EXPECT_EQ(libpreprocessor::Searcher { "a" }.found_in(""), false);
+}
+
+TEST(searcher, matches_find)
+{
+    std::mt19937 generator { 42 };
+
+    // a small alphabet makes for plenty of partial matches.
+    auto const fnRandomString = [&generator] (size_t size) {
+        std::string result(size, 'a');
+        for (auto& character : result) character = static_cast<char>('a' + generator() % 3);
+        return result;
+    };
+
+    for (auto step = 0; step < 2000; step += 1)
+    {
+        auto const haystack = fnRandomString(generator() % 64);
+        auto const needle = fnRandomString(1 + generator() % 12);
+
+        libpreprocessor::Searcher const searcher { needle };
+        EXPECT_EQ(searcher.found_in(haystack), haystack.find(needle) != std::string::npos);
+    }
+}
+
+TEST(searcher, constant_needle)
+{
+    using namespace std::literals;
+
+    libpreprocessor::PreprocessorContext context {
+        .environmentVariables = {
+            { "ENV:LIST", std::string(4096, 'a') + "needle-in-a-haystack" },
+            { "ENV:NEEDLE", "needle" }
+        }
+    };
+
+    auto static constexpr source =
+        "%IF [<|ENV:LIST|> CONTAINS <needle-in-a>]:\n"
+        "    constant!\n"
+        "%END\n"
+        "%IF [<|ENV:LIST|> CONTAINS <|ENV:NEEDLE|>]:\n"
+        "    dynamic!\n"
+        "%END\n"
+        "%IF [<|ENV:LIST|> CONTAINS <haystacks>]:\n"
+        "    missing!\n"
+        "%END\n"sv;
+
+    auto const result = libpreprocessor::process(source, context);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "    constant!\n    dynamic!\n");
+}
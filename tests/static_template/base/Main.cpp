@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/Interpreter.hpp>
+#include <libpreprocessor/StaticTemplate.hpp>
+#include <libpreprocessor/TemplateImage.hpp>
+
+#include <array>
+#include <string>
+#include <string_view>
+
+// a template the compiled program would refuse to build from, along with the line `check_syntax` blames.
+struct Rejected
+{
+    std::string_view source {};
+    size_t line {};
+};
+
+static constexpr Rejected rejected_g[] {
+    { "%IF [<|ENV:A|>]:\n    a\n", 1 },
+    { "%FOO [<a>]:\n    a\n%END\n", 1 },
+    { "%IF <a>:\n    a\n%END\n", 1 },
+    { "%IF [<a>]\n    a\n%END\n", 1 },
+    { "%IF [<a]:\n    a\n%END\n", 1 },
+    { "%IF [<a>:\n    a\n%END\n", 1 },
+    { "first\n\n%PRINT\n", 3 },
+    { "%SWITCH [<a>]:\n    %CASE [<a>]:\n        a\n    %END\n", 1 },
+    { "%SWITCH [<a>]:\n    %DEFAULT\n    %END\n%END\n", 2 },
+};
+
+// templates runtime `compile` takes, reading past what they get wrong, that `check_syntax` refuses.
+static constexpr Rejected stricter_g[] {
+    { "a\n%END\n", 2 },
+    { "%IF [<a>]:\n%ELSE:\n%ELSE:\n%END\n", 3 },
+    { "%IF [<a>]:\n    %DEFAULT:\n    %END\n%END\n", 2 },
+};
+
+static_assert(!libpreprocessor::check_syntax("%IF [<a>]: %END\n"));
+static_assert(!libpreprocessor::check_syntax("50% off\n%PRINT [<done>]\n"));
+static_assert(!libpreprocessor::check_syntax("%IF [[<|ENV:A|> CONTAINS <b>] AND <c>]:\n    a\n%ELSE:\n    b\n%END\n"));
+static_assert(libpreprocessor::check_syntax(rejected_g[0].source).line == rejected_g[0].line);
+static_assert(libpreprocessor::check_syntax("%END\n"));
+static_assert(libpreprocessor::check_syntax("%IF [<a>]:\n%ELSE:\n%ELSE:\n%END\n"));
+static_assert(!libpreprocessor::save_static_image("%IF [<a>]:\n%ELSE:\n%ELSE:\n%END\n").error);
+static_assert(libpreprocessor::save_static_image("%SWITCH [<a>]:\n    %DEFAULT\n    %END\n%END\n").error.line == 2);
+
+TEST(static_template, rejected_at_runtime_too)
+{
+    for (auto const& [source, line] : rejected_g)
+    {
+        auto const error = libpreprocessor::check_syntax(source);
+        EXPECT_EQ(static_cast<bool>(error), true);
+        EXPECT_EQ(error.line, line);
+        EXPECT_EQ(!libpreprocessor::compile(source).has_value(), true);
+    }
+}
+
+TEST(static_template, stricter_than_runtime_compile)
+{
+    for (auto const& [source, line] : stricter_g)
+    {
+        auto const error = libpreprocessor::check_syntax(source);
+        EXPECT_EQ(static_cast<bool>(error), true);
+        EXPECT_EQ(error.line, line);
+        EXPECT_EQ(!libpreprocessor::compile(source).has_value(), false);
+    }
+}
+
+TEST(static_template, parsed_like_runtime_compile)
+{
+    static constexpr std::array lines_g {
+        "%IF [<a>]:", "%IF [NOT [<a> EQUALS <b>]]:", "%IF [<a> AND]:", "%ELSE:", "%ELSE",
+        "%SWITCH [<a>]:", "%CASE [<a>]:", "%DEFAULT:", "%DEFAULT", "%END",
+        "%PRINT [<a> OR <b>]", "%PRINT <a>", "%IF [<a>]: %END", "%CASE [<|ENV:A|> CONTAINS <b>]:", "text",
+    };
+
+    auto rejections = 0zu;
+
+    // every template of up to four of those lines.
+    for (auto count = 1zu, total = lines_g.size(); count <= 4; count += 1, total *= lines_g.size())
+    {
+        for (auto combination = 0zu; combination < total; combination += 1)
+        {
+            std::string source {};
+
+            for (auto index = 0zu, rest = combination; index < count; index += 1, rest /= lines_g.size())
+                source.append(lines_g[rest % lines_g.size()]).append("\n");
+
+            auto const error = libpreprocessor::check_syntax(source);
+            auto const saved = libpreprocessor::save_static_image(source);
+            auto const runtime = libpreprocessor::compile(std::string_view { source });
+            if (error) rejections += 1;
+
+            if (!error)
+            {
+                EXPECT_EQ(!runtime.has_value(), false) << source << runtime.error().message();
+            }
+
+            if (saved.error)
+            {
+                EXPECT_EQ(!runtime.has_value(), true) << source;
+                continue;
+            }
+
+            // what's only refused past the parser is refused when the image is loaded.
+            EXPECT_EQ(libpreprocessor::load_image(saved.image).has_value(), runtime.has_value()) << source;
+            if (runtime.has_value())
+            {
+                EXPECT_EQ(saved.image, libpreprocessor::save_image(runtime.value()).value()) << source;
+            }
+        }
+    }
+
+    EXPECT_GT(rejections, 0zu);
+}
+
+TEST(static_template, renders_like_runtime_compile)
+{
+    using namespace std::literals;
+
+    auto static constexpr source =
+        "%SWITCH [<|ENV:REGION|>]:\n"
+        "    %CASE [<eu>]:\n"
+        "        region eu\n"
+        "    %END\n"
+        "    %DEFAULT:\n"
+        "        region unknown\n"
+        "    %END\n"
+        "%END\n"sv;
+
+    auto const& compiled = libpreprocessor::compile<
+        "%SWITCH [<|ENV:REGION|>]:\n"
+        "    %CASE [<eu>]:\n"
+        "        region eu\n"
+        "    %END\n"
+        "    %DEFAULT:\n"
+        "        region unknown\n"
+        "    %END\n"
+        "%END\n">();
+    auto const runtime = libpreprocessor::compile(source);
+    ASSERT_EQ(!compiled.has_value(), false);
+    ASSERT_EQ(!runtime.has_value(), false);
+
+    for (auto const region : { "eu", "us" })
+    {
+        libpreprocessor::PreprocessorContext const context { .environmentVariables = { { "ENV:REGION", region } } };
+
+        auto const expected = libpreprocessor::interpret(runtime.value(), context);
+        auto const result = libpreprocessor::interpret(compiled.value(), context);
+
+        EXPECT_EQ(!result.has_value(), false);
+        EXPECT_EQ(result.value(), expected.value());
+    }
+}
+
+TEST(static_template, compiled_once)
+{
+    auto const& first = libpreprocessor::compile<"%PRINT [<hello>]\n">();
+    auto const& second = libpreprocessor::compile<"%PRINT [<hello>]\n">();
+
+    EXPECT_EQ(&first, &second);
+    EXPECT_EQ(first.value().prints, true);
+}
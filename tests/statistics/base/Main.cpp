@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/Processor.hpp>
+
+#include <optional>
+#include <string>
+
+static constexpr auto source_g =
+    "header\n"
+    "%IF [<|ENV:A|> EQUALS <x>]:\n"
+    "    %PRINT [<|ENV:B|>]\n"
+    "    a is x\n"
+    "%END\n";
+
+TEST(statistics, process)
+{
+    using namespace std::literals;
+
+    libpreprocessor::PreprocessorContext context {
+        .environmentVariables = {
+            { "ENV:A", "x" },
+            { "ENV:B", "y" },
+            { "ENV:UNREAD", "z" }
+        },
+        .print = { .type = libpreprocessor::PrintSink::Type::DISCARD }
+    };
+
+    libpreprocessor::Statistics statistics {};
+
+    auto const result = libpreprocessor::process(std::string_view { source_g }, context, statistics);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "header\n    a is x\n");
+
+    auto const fnNodes = [&statistics] (libpreprocessor::INode::Type type) { return statistics.nodes[static_cast<size_t>(type)]; };
+
+    EXPECT_GT(statistics.tokens, 0zu);
+    EXPECT_EQ(fnNodes(libpreprocessor::INode::Type::STATEMENT), 2zu);
+    EXPECT_EQ(fnNodes(libpreprocessor::INode::Type::OPERATOR), 1zu);
+    EXPECT_EQ(fnNodes(libpreprocessor::INode::Type::LITERAL), 3zu);
+    EXPECT_EQ(fnNodes(libpreprocessor::INode::Type::CONTENT), 2zu);
+
+    EXPECT_EQ(statistics.outputBytes, result.value().size());
+    EXPECT_GE(statistics.peakScratchBytes, result.value().size());
+    // the %PRINT statement is discarded without being evaluated, so |ENV:B| is never read.
+    EXPECT_EQ(statistics.variableLookups, 1zu);
+    EXPECT_GT(statistics.interpreting.count(), 0);
+}
+
+TEST(statistics, compile_only)
+{
+    libpreprocessor::Statistics statistics {};
+    statistics.outputBytes = 42;
+
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g }, statistics);
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    EXPECT_GT(statistics.tokens, 0zu);
+    EXPECT_EQ(statistics.outputBytes, 0zu);
+    EXPECT_EQ(statistics.interpreting.count(), 0);
+}
+
+TEST(statistics, variable_lookups)
+{
+    static constexpr auto source =
+        "%IF [[<|ENV:A|> EQUALS <x>] AND [<|ENV:B|> EQUALS <y>]]:\n"
+        "    %PRINT [<|ENV:B|-|ENV:B|>]\n"
+        "%ELSE:\n"
+        "    %PRINT [<|ENV:C|>]\n"
+        "%END\n";
+
+    auto const compiled = libpreprocessor::compile(std::string_view { source });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    auto const fnLookups = [&compiled] (std::string_view a) {
+        libpreprocessor::PreprocessorContext context {
+            .environmentVariables = {
+                { "ENV:A", std::string { a } },
+                { "ENV:B", "y" },
+                { "ENV:C", "z" }
+            },
+            .print = { .type = libpreprocessor::PrintSink::Type::CALLBACK, .callback = [] (std::string_view) {} }
+        };
+
+        libpreprocessor::Statistics statistics {};
+        EXPECT_EQ(!libpreprocessor::interpret(compiled.value(), context, statistics).has_value(), false);
+        return statistics.variableLookups;
+    };
+
+    // |ENV:A| and |ENV:B| in the condition, then |ENV:B| twice more in the taken branch.
+    EXPECT_EQ(fnLookups("x"), 4zu);
+    // the condition stops at |ENV:A|, and the other branch only reads |ENV:C|.
+    EXPECT_EQ(fnLookups("w"), 2zu);
+}
+
+TEST(statistics, provided_values_are_measured)
+{
+    auto const compiled = libpreprocessor::compile(std::string_view { "%PRINT [<|ENV:LARGE|>]\n" });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    auto calls = 0zu;
+
+    libpreprocessor::PreprocessorContext context {
+        .print = { .type = libpreprocessor::PrintSink::Type::CALLBACK, .callback = [] (std::string_view) {} },
+        .provider = [&calls] (std::string_view) -> std::optional<std::string> {
+            calls += 1;
+            return std::string(4096, 'x');
+        }
+    };
+
+    libpreprocessor::Statistics statistics {};
+    EXPECT_EQ(!libpreprocessor::interpret(compiled.value(), context, statistics).has_value(), false);
+
+    EXPECT_EQ(calls, 1zu);
+    EXPECT_EQ(statistics.variableLookups, 1zu);
+    EXPECT_EQ(statistics.outputBytes, 0zu);
+    EXPECT_GE(statistics.peakScratchBytes, 4096zu);
+}
@@ -644,3 +644,88 @@ TEST(surrounded_multiple_switch_statement, multiple_case_default)
     EXPECT_STREQ(result.value().data(), "hello!\n        how are you?\nhello!\n        how are you?\nhello!\n");
 }
 
+
+TEST(switch_statement, constant_and_dynamic_case_order)
+{
+    using namespace std::literals;
+
+    auto static constexpr source =
+        "%SWITCH [<|ENV:X|>]:\n"
+        "    %CASE [<a>]:\n"
+        "        first!\n"
+        "    %END\n"
+        "    %CASE [<|ENV:Y|>]:\n"
+        "        dynamic!\n"
+        "    %END\n"
+        "    %CASE [<b>]:\n"
+        "        second!\n"
+        "    %END\n"
+        "    %CASE [<b>]:\n"
+        "        duplicate!\n"
+        "    %END\n"
+        "    %DEFAULT:\n"
+        "        default!\n"
+        "    %END\n"
+        "%END\n"sv;
+
+    auto const fnProcess = [] (auto x, auto y) {
+        libpreprocessor::PreprocessorContext context {
+            .environmentVariables = {
+                { "ENV:X", x },
+                { "ENV:Y", y }
+            }
+        };
+        return libpreprocessor::process(source, context);
+    };
+
+    {
+    auto const result = fnProcess("b", "b");
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "        dynamic!\n");
+    }
+    {
+    auto const result = fnProcess("b", "z");
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "        second!\n");
+    }
+    {
+    auto const result = fnProcess("a", "a");
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "        first!\n");
+    }
+    {
+    auto const result = fnProcess("z", "z");
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "        dynamic!\n");
+    }
+    {
+    auto const result = fnProcess("q", "z");
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "        default!\n");
+    }
+}
+
+TEST(switch_statement, many_constant_cases)
+{
+    using namespace std::literals;
+
+    std::string source = "%SWITCH [<|ENV:X|>]:\n";
+    for (auto index = 0; index < 500; index += 1)
+    {
+        source += "    %CASE [<" + std::to_string(index) + ">]:\n        case " + std::to_string(index) + "!\n    %END\n";
+    }
+    source += "%END\n";
+
+    for (auto const index : { 0, 250, 499 })
+    {
+        libpreprocessor::PreprocessorContext context {
+            .environmentVariables = {
+                { "ENV:X", std::to_string(index) }
+            }
+        };
+
+        auto const result = libpreprocessor::process(std::string_view { source }, context);
+        EXPECT_EQ(!result.has_value(), false);
+        EXPECT_EQ(result.value(), "        case " + std::to_string(index) + "!\n");
+    }
+}
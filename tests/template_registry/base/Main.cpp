@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/TemplateRegistry.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// a directory of its own for every test, removed along with what's left in it.
+class TemporaryDirectory
+{
+public:
+    explicit TemporaryDirectory(std::string_view name)
+        : _path { std::filesystem::temp_directory_path() / name }
+    {
+        std::filesystem::remove_all(_path);
+        std::filesystem::create_directories(_path);
+    }
+
+    ~TemporaryDirectory() { std::filesystem::remove_all(_path); }
+
+    std::filesystem::path write(std::string_view name, std::string_view contents) const
+    {
+        auto const path = _path / name;
+        std::ofstream { path, std::ios::binary } << contents;
+        return path;
+    }
+
+    std::filesystem::path const& path() const noexcept { return _path; }
+
+private:
+    std::filesystem::path _path {};
+};
+
+// file systems with a coarse clock could otherwise leave a rewritten file with the time it had before.
+static void advance_modification_time(std::filesystem::path const& path)
+{
+    std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds { 5 });
+}
+
+TEST(template_registry, compiles_once)
+{
+    TemporaryDirectory const directory { "template_registry_compiles_once" };
+    auto const path = directory.write("greeting.txt", "hello |ENV:NAME|\n");
+
+    libpreprocessor::TemplateRegistry registry {};
+
+    auto const first = registry.find(path);
+    auto const second = registry.find(directory.path() / "." / "greeting.txt");
+    ASSERT_EQ(!first.has_value(), false);
+    ASSERT_EQ(!second.has_value(), false);
+
+    EXPECT_EQ(first.value(), second.value());
+    EXPECT_EQ(registry.statistics().compilations, 1zu);
+    EXPECT_EQ(registry.statistics().hits, 1zu);
+    EXPECT_EQ(registry.statistics().entries, 1zu);
+}
+
+TEST(template_registry, recompiles_changed_files)
+{
+    TemporaryDirectory const directory { "template_registry_recompiles_changed_files" };
+    auto const path = directory.write("greeting.txt", "%IF [<|ENV:A|>]:\n    old\n%END\n");
+
+    libpreprocessor::TemplateRegistry registry {};
+    libpreprocessor::PreprocessorContext const context { .environmentVariables = { { "ENV:A", "TRUE" } } };
+
+    auto const old = registry.find(path);
+    ASSERT_EQ(!old.has_value(), false);
+
+    directory.write("greeting.txt", "%IF [<|ENV:A|>]:\n    newer\n%END\n");
+    advance_modification_time(path);
+
+    auto const result = registry.process(path, context);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_EQ(result.value(), "    newer\n");
+    EXPECT_EQ(registry.statistics().compilations, 2zu);
+
+    // what was handed out before the file changed keeps rendering what it was compiled from.
+    EXPECT_EQ(libpreprocessor::interpret(*old.value(), context).value(), "    old\n");
+}
+
+TEST(template_registry, unchanged_contents_with_hashing)
+{
+    TemporaryDirectory const directory { "template_registry_unchanged_contents_with_hashing" };
+    auto const path = directory.write("greeting.txt", "hello\n");
+
+    libpreprocessor::TemplateRegistry registry { { .hashContents = true } };
+
+    auto const first = registry.find(path);
+    ASSERT_EQ(!first.has_value(), false);
+
+    directory.write("greeting.txt", "hello\n");
+    advance_modification_time(path);
+
+    auto const second = registry.find(path);
+    ASSERT_EQ(!second.has_value(), false);
+    EXPECT_EQ(first.value(), second.value());
+    EXPECT_EQ(registry.statistics().compilations, 1zu);
+
+    directory.write("greeting.txt", "howdy\n");
+    advance_modification_time(path);
+
+    auto const third = registry.find(path);
+    ASSERT_EQ(!third.has_value(), false);
+    EXPECT_NE(first.value(), third.value());
+    EXPECT_EQ(registry.statistics().compilations, 2zu);
+}
+
+TEST(template_registry, missing_and_invalid_files)
+{
+    TemporaryDirectory const directory { "template_registry_missing_and_invalid_files" };
+    auto const path = directory.write("broken.txt", "%IF [<a>]:\n    never closed\n");
+
+    libpreprocessor::TemplateRegistry registry {};
+
+    EXPECT_EQ(!registry.find(directory.path() / "missing.txt").has_value(), true);
+
+    // compiled from what the registry read, but still located by the file it was read from.
+    auto const broken = registry.find(path);
+    ASSERT_EQ(!broken.has_value(), true);
+    EXPECT_NE(broken.error().message().find(path.string()), std::string::npos);
+    EXPECT_EQ(registry.statistics().entries, 0zu);
+}
+
+TEST(template_registry, concurrent_lookups)
+{
+    TemporaryDirectory const directory { "template_registry_concurrent_lookups" };
+
+    std::vector<std::filesystem::path> paths {};
+    for (auto index = 0zu; index < 32; index += 1)
+        paths.push_back(directory.write(std::to_string(index) + ".txt", "template " + std::to_string(index) + "\n"));
+
+    libpreprocessor::TemplateRegistry registry {};
+
+    for (auto const& path : paths)
+        ASSERT_EQ(!registry.find(path).has_value(), false);
+
+    std::vector<std::thread> threads {};
+    std::atomic<size_t> failures {};
+
+    for (auto thread = 0zu; thread < 8; thread += 1)
+    {
+        threads.emplace_back([&] {
+            for (auto round = 0zu; round < 100; round += 1)
+            {
+                for (auto index = 0zu; index < paths.size(); index += 1)
+                {
+                    auto const result = registry.process(paths[index], {});
+                    if (!result.has_value() || result.value() != "template " + std::to_string(index) + "\n") failures += 1;
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(failures.load(), 0zu);
+    EXPECT_EQ(registry.statistics().compilations, paths.size());
+    EXPECT_EQ(registry.statistics().hits, 8zu * 100 * paths.size());
+}
+
+TEST(template_registry, erase_and_clear)
+{
+    TemporaryDirectory const directory { "template_registry_erase_and_clear" };
+    auto const first = directory.write("first.txt", "first\n");
+    auto const second = directory.write("second.txt", "second\n");
+
+    libpreprocessor::TemplateRegistry registry {};
+    ASSERT_EQ(!registry.find(first).has_value(), false);
+    ASSERT_EQ(!registry.find(second).has_value(), false);
+
+    registry.erase(first);
+    EXPECT_EQ(registry.statistics().entries, 1zu);
+
+    registry.clear();
+    EXPECT_EQ(registry.statistics().entries, 0zu);
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/TemplateRegistry.hpp>
+#include <libpreprocessor/TemplateWatcher.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// a directory of its own for every test, removed along with what's left in it.
+class TemporaryDirectory
+{
+public:
+    explicit TemporaryDirectory(std::string_view name)
+        : _path { std::filesystem::temp_directory_path() / name }
+    {
+        std::filesystem::remove_all(_path);
+        std::filesystem::create_directories(_path);
+    }
+
+    ~TemporaryDirectory() { std::filesystem::remove_all(_path); }
+
+    std::filesystem::path write(std::string_view name, std::string_view contents) const
+    {
+        auto const path = _path / name;
+        std::ofstream { path, std::ios::binary } << contents;
+        return path;
+    }
+
+    std::filesystem::path const& path() const noexcept { return _path; }
+
+private:
+    std::filesystem::path _path {};
+};
+
+// the watcher reacts from a thread of its own, so tests give it a while to.
+static bool eventually(std::function<bool()> const& fnCondition)
+{
+    auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds { 5 };
+
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        if (fnCondition()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds { 5 });
+    }
+
+    return fnCondition();
+}
+
+static std::string render(libpreprocessor::TemplateRegistry& registry, std::filesystem::path const& path)
+{
+    auto const result = registry.process(path, {});
+    return result.has_value() ? result.value() : result.error().message();
+}
+
+TEST(template_watcher, reloads_written_files)
+{
+    TemporaryDirectory const directory { "template_watcher_reloads_written_files" };
+    auto const path = directory.write("greeting.txt", "hello\n");
+
+    libpreprocessor::TemplateRegistry registry { { .revalidate = false } };
+
+    auto watcher = libpreprocessor::TemplateWatcher::create(registry);
+    ASSERT_EQ(!watcher.has_value(), false);
+    ASSERT_EQ(!watcher.value()->watch(directory.path()).has_value(), false);
+
+    auto const old = registry.find(path);
+    ASSERT_EQ(!old.has_value(), false);
+
+    directory.write("greeting.txt", "howdy\n");
+
+    EXPECT_EQ(eventually([&] { return render(registry, path) == "howdy\n"; }), true);
+    EXPECT_EQ(registry.statistics().compilations, 2zu);
+
+    // a render holding the template from before keeps rendering it.
+    EXPECT_EQ(libpreprocessor::interpret(*old.value(), {}).value(), "hello\n");
+}
+
+TEST(template_watcher, reloads_files_renamed_over)
+{
+    TemporaryDirectory const directory { "template_watcher_reloads_files_renamed_over" };
+    auto const path = directory.write("greeting.txt", "hello\n");
+
+    libpreprocessor::TemplateRegistry registry { { .revalidate = false } };
+
+    auto watcher = libpreprocessor::TemplateWatcher::create(registry);
+    ASSERT_EQ(!watcher.has_value(), false);
+    ASSERT_EQ(!watcher.value()->watch(path).has_value(), false);
+
+    ASSERT_EQ(render(registry, path), "hello\n");
+
+    std::filesystem::rename(directory.write("greeting.txt.new", "howdy\n"), path);
+    EXPECT_EQ(eventually([&] { return render(registry, path) == "howdy\n"; }), true);
+
+    // watching the file through its directory survives it being replaced.
+    std::filesystem::rename(directory.write("greeting.txt.new", "hey\n"), path);
+    EXPECT_EQ(eventually([&] { return render(registry, path) == "hey\n"; }), true);
+}
+
+TEST(template_watcher, keeps_templates_failing_to_compile)
+{
+    TemporaryDirectory const directory { "template_watcher_keeps_templates_failing_to_compile" };
+    auto const path = directory.write("greeting.txt", "hello\n");
+
+    std::mutex mutex {};
+    std::vector<std::filesystem::path> failed {};
+
+    libpreprocessor::TemplateRegistry registry { { .revalidate = false } };
+
+    auto watcher = libpreprocessor::TemplateWatcher::create(registry, {
+        .onError = [&] (std::filesystem::path const& failedPath, std::string_view) {
+            std::scoped_lock const lock { mutex };
+            failed.push_back(failedPath);
+        }
+    });
+    ASSERT_EQ(!watcher.has_value(), false);
+    ASSERT_EQ(!watcher.value()->watch(directory.path()).has_value(), false);
+
+    ASSERT_EQ(render(registry, path), "hello\n");
+
+    directory.write("greeting.txt", "%IF [<TRUE>]:\n    never closed\n");
+
+    EXPECT_EQ(eventually([&] { std::scoped_lock const lock { mutex }; return !failed.empty(); }), true);
+    EXPECT_EQ(render(registry, path), "hello\n");
+}
+
+TEST(template_watcher, forgets_removed_files)
+{
+    TemporaryDirectory const directory { "template_watcher_forgets_removed_files" };
+    auto const path = directory.write("greeting.txt", "hello\n");
+
+    libpreprocessor::TemplateRegistry registry { { .revalidate = false } };
+
+    auto watcher = libpreprocessor::TemplateWatcher::create(registry);
+    ASSERT_EQ(!watcher.has_value(), false);
+    ASSERT_EQ(!watcher.value()->watch(directory.path()).has_value(), false);
+
+    ASSERT_EQ(render(registry, path), "hello\n");
+
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(eventually([&] { return registry.statistics().entries == 0; }), true);
+    EXPECT_EQ(!registry.find(path).has_value(), true);
+}
+
+TEST(template_watcher, missing_paths)
+{
+    TemporaryDirectory const directory { "template_watcher_missing_paths" };
+
+    libpreprocessor::TemplateRegistry registry {};
+
+    auto watcher = libpreprocessor::TemplateWatcher::create(registry);
+    ASSERT_EQ(!watcher.has_value(), false);
+    EXPECT_EQ(!watcher.value()->watch(directory.path() / "missing.txt").has_value(), true);
+}
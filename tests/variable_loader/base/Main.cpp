@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/VariableLoader.hpp>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+static std::filesystem::path write_file(std::string_view name, std::string_view contents)
+{
+    auto const path = std::filesystem::temp_directory_path() / name;
+    std::ofstream { path, std::ios::binary } << contents;
+    return path;
+}
+
+TEST(variable_loader, parse)
+{
+    libpreprocessor::VariableMap variables { { "ENV:KEPT", "kept" }, { "ENV:A", "replaced" } };
+
+    auto static constexpr source =
+        "# a comment\n"
+        "\n"
+        "ENV:A=x\n"
+        "  ENV:B = spaced out  \r\n"
+        "export ENV:C=\"quoted # value\"\n"
+        "ENV:D='single'\n"
+        "ENV:E=\n"
+        "ENV:F=a=b\n"
+        "ENV:G=last";
+
+    auto const result = libpreprocessor::parse_variables(source, variables);
+    EXPECT_EQ(!result.has_value(), false);
+
+    EXPECT_EQ(variables.size(), 8zu);
+    EXPECT_EQ(variables.at("ENV:KEPT"), "kept");
+    EXPECT_EQ(variables.at("ENV:A"), "x");
+    EXPECT_EQ(variables.at("ENV:B"), "spaced out");
+    EXPECT_EQ(variables.at("ENV:C"), "quoted # value");
+    EXPECT_EQ(variables.at("ENV:D"), "single");
+    EXPECT_EQ(variables.at("ENV:E"), "");
+    EXPECT_EQ(variables.at("ENV:F"), "a=b");
+    EXPECT_EQ(variables.at("ENV:G"), "last");
+}
+
+TEST(variable_loader, malformed)
+{
+    libpreprocessor::VariableMap variables {};
+
+    EXPECT_EQ(!libpreprocessor::parse_variables("ENV:A=x\nENV:B\n", variables).has_value(), true);
+    EXPECT_EQ(!libpreprocessor::parse_variables("=x\n", variables).has_value(), true);
+}
+
+TEST(variable_loader, file)
+{
+    auto const path = write_file("libpreprocessor_variable_loader.env", "ENV:A=x\nENV:B=y\n");
+
+    libpreprocessor::VariableMap variables {};
+    auto const result = libpreprocessor::load_variables(path, variables);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_EQ(variables.size(), 2zu);
+    EXPECT_EQ(variables.at("ENV:B"), "y");
+
+    auto const empty = write_file("libpreprocessor_variable_loader_empty.env", "");
+    EXPECT_EQ(!libpreprocessor::load_variables(empty, variables).has_value(), false);
+    std::filesystem::remove(empty);
+
+    EXPECT_EQ(!libpreprocessor::load_variables(std::filesystem::temp_directory_path() / "libpreprocessor_missing.env", variables).has_value(), true);
+}
+
+TEST(variable_loader, process_environment)
+{
+    libpreprocessor::VariableMap variables {};
+    libpreprocessor::load_process_environment(variables);
+
+    if (auto const* path = std::getenv("PATH"))
+    {
+        EXPECT_EQ(variables.contains("PATH"), true);
+        EXPECT_EQ(variables.at("PATH"), path);
+    }
+}
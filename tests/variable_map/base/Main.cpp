@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/VariableMap.hpp>
+
+#include <random>
+#include <string>
+#include <unordered_map>
+
+TEST(variable_map, lookup)
+{
+    using namespace std::literals;
+
+    libpreprocessor::VariableMap variables {
+        { "ENV:A", "x" },
+        { "ENV:B", "y" },
+        { "ENV:A", "z" }
+    };
+
+    EXPECT_EQ(variables.size(), 2zu);
+    EXPECT_EQ(variables.contains("ENV:A"sv), true);
+    EXPECT_EQ(variables.contains("ENV:C"sv), false);
+    EXPECT_EQ(variables.find("ENV:C"sv), variables.end());
+    EXPECT_STREQ(variables.find("ENV:A"sv)->second.data(), "x");
+    EXPECT_STREQ(variables.at("ENV:B"sv).data(), "y");
+}
+
+TEST(variable_map, insert_and_assign)
+{
+    using namespace std::literals;
+
+    libpreprocessor::VariableMap variables {};
+
+    EXPECT_EQ(variables.insert("ENV:A", "x"), true);
+    EXPECT_EQ(variables.insert("ENV:A", "y"), false);
+    EXPECT_STREQ(variables.at("ENV:A").data(), "x");
+
+    EXPECT_EQ(variables.insert_or_assign("ENV:A", "y"), false);
+    EXPECT_STREQ(variables.at("ENV:A").data(), "y");
+
+    variables["ENV:B"] = "z";
+    EXPECT_STREQ(variables.at("ENV:B").data(), "z");
+    EXPECT_EQ(variables.size(), 2zu);
+}
+
+TEST(variable_map, erase)
+{
+    using namespace std::literals;
+
+    libpreprocessor::VariableMap variables {
+        { "ENV:A", "x" },
+        { "ENV:B", "y" },
+        { "ENV:C", "z" }
+    };
+
+    EXPECT_EQ(variables.erase("ENV:A"), true);
+    EXPECT_EQ(variables.erase("ENV:A"), false);
+    EXPECT_EQ(variables.size(), 2zu);
+    EXPECT_EQ(variables.contains("ENV:A"), false);
+    EXPECT_STREQ(variables.at("ENV:B").data(), "y");
+    EXPECT_STREQ(variables.at("ENV:C").data(), "z");
+}
+
+TEST(variable_map, matches_unordered_map)
+{
+    std::mt19937 generator { 42 };
+    std::uniform_int_distribution<int> keys { 0, 2000 };
+    std::uniform_int_distribution<int> operations { 0, 2 };
+
+    libpreprocessor::VariableMap variables {};
+    std::unordered_map<std::string, std::string> reference {};
+
+    for (auto iteration = 0; iteration < 50000; iteration += 1)
+    {
+        auto const key = "ENV:" + std::to_string(keys(generator));
+        auto const value = std::to_string(iteration);
+
+        switch (operations(generator))
+        {
+        case 0: {
+            EXPECT_EQ(variables.insert_or_assign(key, value), !reference.contains(key));
+            reference.insert_or_assign(key, value);
+            break;
+        }
+        case 1: {
+            EXPECT_EQ(variables.erase(key), reference.erase(key) == 1);
+            break;
+        }
+        default: {
+            auto const entry = variables.find(key);
+            EXPECT_EQ(entry != variables.end(), reference.contains(key));
+            if (entry != variables.end())
+            {
+                EXPECT_EQ(entry->second, reference.at(key));
+            }
+            break;
+        }
+        }
+    }
+
+    EXPECT_EQ(variables.size(), reference.size());
+
+    for (auto const& [name, value] : variables)
+    {
+        EXPECT_EQ(reference.at(name), value);
+    }
+}
+
+TEST(variable_map, shared_values)
+{
+    libpreprocessor::VariableMap variables {
+        { "ENV:A", std::string(1zu << 20, 'x') },
+        { "ENV:B", "y" }
+    };
+
+    auto const copy = variables;
+    EXPECT_EQ(copy.at("ENV:A").data(), variables.at("ENV:A").data());
+    EXPECT_EQ(copy.at("ENV:A"), variables.at("ENV:A"));
+
+    variables.insert_or_assign("ENV:A", "z");
+    EXPECT_EQ(variables.at("ENV:A"), "z");
+    EXPECT_EQ(copy.at("ENV:A").size(), 1zu << 20);
+    EXPECT_EQ(copy.at("ENV:B"), std::string { "y" });
+
+    libpreprocessor::VariableValue const empty {};
+    EXPECT_STREQ(empty.data(), "");
+    EXPECT_EQ(empty, "");
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/Interpreter.hpp>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+static constexpr auto source_g =
+    "%IF [<|ENV:HOST|> EQUALS <builder>]:\n"
+    "    %PRINT [<built on |ENV:HOST| by |ENV:USER|>]\n"
+    "    host is builder\n"
+    "%ELSE:\n"
+    "    %PRINT [<|ENV:GIT|>]\n"
+    "%END\n";
+
+// counts how often it was asked about every variable.
+struct CountingProvider
+{
+    std::optional<std::string> operator()(std::string_view name)
+    {
+        calls[std::string { name }] += 1;
+        if (name == "ENV:HOST") return "builder";
+        if (name == "ENV:GIT") return "0123abcd";
+        return std::nullopt;
+    }
+
+    std::map<std::string, size_t>& calls;
+};
+
+TEST(variable_provider, only_asked_on_read)
+{
+    std::map<std::string, size_t> calls {};
+    std::vector<std::string> lines {};
+
+    libpreprocessor::PreprocessorContext const context {
+        .environmentVariables = { { "ENV:USER", "me" } },
+        .print = {
+            .type = libpreprocessor::PrintSink::Type::CALLBACK,
+            .callback = [&lines] (std::string_view line) { lines.emplace_back(line); }
+        },
+        .provider = CountingProvider { calls }
+    };
+
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    auto const result = libpreprocessor::interpret(compiled.value(), context);
+    EXPECT_EQ(!result.has_value(), false);
+    EXPECT_STREQ(result.value().data(), "    host is builder\n");
+
+    EXPECT_EQ(lines, (std::vector<std::string> { "built on builder by me" }));
+    EXPECT_EQ(calls, (std::map<std::string, size_t> { { "ENV:HOST", 1 } }));
+}
+
+TEST(variable_provider, memoized_per_render)
+{
+    std::map<std::string, size_t> calls {};
+
+    libpreprocessor::PreprocessorContext const context {
+        .print = { .type = libpreprocessor::PrintSink::Type::DISCARD },
+        .provider = CountingProvider { calls }
+    };
+
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    libpreprocessor::RenderScratch scratch {};
+
+    for (auto index = 0zu; index < 3; index += 1)
+    {
+        auto const result = libpreprocessor::interpret(compiled.value(), context, scratch);
+        EXPECT_EQ(!result.has_value(), false);
+        EXPECT_EQ(result.value(), "    host is builder\n");
+    }
+
+    EXPECT_EQ(calls, (std::map<std::string, size_t> { { "ENV:HOST", 3 } }));
+}
+
+TEST(variable_provider, session_and_unknown_variable)
+{
+    std::map<std::string, size_t> calls {};
+    std::vector<std::string> lines {};
+
+    libpreprocessor::PreprocessorContext context {
+        .print = {
+            .type = libpreprocessor::PrintSink::Type::CALLBACK,
+            .callback = [&lines] (std::string_view line) { lines.emplace_back(line); }
+        },
+        .provider = CountingProvider { calls }
+    };
+
+    auto const compiled = libpreprocessor::compile(std::string_view { source_g });
+    EXPECT_EQ(!compiled.has_value(), false);
+
+    libpreprocessor::RenderSession session { compiled.value(), context };
+    EXPECT_STREQ(session.render().value().data(), "    host is builder\n");
+    EXPECT_STREQ(session.update("ENV:HOST", "laptop").value().data(), "");
+
+    EXPECT_EQ(lines, (std::vector<std::string> { "built on builder by ENV:USER", "0123abcd" }));
+    EXPECT_EQ(calls, (std::map<std::string, size_t> { { "ENV:GIT", 1 }, { "ENV:HOST", 1 }, { "ENV:USER", 1 } }));
+}
@@ -0,0 +1,68 @@
+#include <libpreprocessor/CodeGenerator.hpp>
+#include <libpreprocessor/Compiler.hpp>
+
+#include <fmt/format.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <string>
+
+// usage: libpreprocessor_codegen <template> <header> <function> [namespace]
+int main(int argc, char** argv)
+{
+    std::span const arguments { argv, static_cast<size_t>(argc) };
+
+    if (arguments.size() != 4 && arguments.size() != 5)
+    {
+        fmt::print(stderr, "usage: {} <template> <header> <function> [namespace]\n", arguments.front());
+        return EXIT_FAILURE;
+    }
+
+    std::filesystem::path const source { arguments[1] };
+    std::filesystem::path const header { arguments[2] };
+
+    auto const compiled = libpreprocessor::compile(source);
+
+    if (!compiled.has_value())
+    {
+        fmt::print(stderr, "{}\n", compiled.error().message());
+        return EXIT_FAILURE;
+    }
+
+    libpreprocessor::CodeGeneratorOptions const options {
+        .functionName = arguments[3],
+        .namespaceName = arguments.size() == 5 ? arguments[4] : "",
+        .source = source.filename().string()
+    };
+
+    auto const code = libpreprocessor::generate_cpp(compiled.value(), options);
+
+    if (!code.has_value())
+    {
+        fmt::print(stderr, "{}\n", code.error().message());
+        return EXIT_FAILURE;
+    }
+
+    // an unchanged header is left alone, so what includes it isn't rebuilt for nothing.
+    if (std::ifstream existing { header, std::ios::binary }; existing)
+    {
+        std::string const contents { std::istreambuf_iterator<char> { existing }, {} };
+        if (contents == code.value()) return EXIT_SUCCESS;
+    }
+
+    if (header.has_parent_path()) std::filesystem::create_directories(header.parent_path());
+
+    std::ofstream output { header, std::ios::binary };
+    output << code.value();
+
+    if (!output)
+    {
+        fmt::print(stderr, "couldn't write \"{}\".\n", header.string());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+#include <libpreprocessor/Compiler.hpp>
+#include <libpreprocessor/TemplateImage.hpp>
+
+#include <fmt/format.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+
+// a C++ string literal holding `image`, split into lines of a few bytes each.
+static std::string quote(std::string_view image)
+{
+    std::string result { "\"" };
+
+    for (auto index = 0zu; index < image.size(); index += 1)
+    {
+        if (index != 0 && index % 32 == 0) result += "\"\n    \"";
+
+        auto const character = static_cast<unsigned char>(image[index]);
+
+        // octal escapes stop after three digits, unlike hexadecimal ones which would swallow a digit after them.
+        if (character == '"' || character == '\\' || character < 0x20 || character >= 0x7f)
+            result += fmt::format("\\{:03o}", character);
+        else
+            result += static_cast<char>(character);
+    }
+
+    return result + "\"";
+}
+
+// usage: libpreprocessor_embed <template> <source> <symbol> [namespace]
+int main(int argc, char** argv)
+{
+    std::span const arguments { argv, static_cast<size_t>(argc) };
+
+    if (arguments.size() != 4 && arguments.size() != 5)
+    {
+        fmt::print(stderr, "usage: {} <template> <source> <symbol> [namespace]\n", arguments.front());
+        return EXIT_FAILURE;
+    }
+
+    std::filesystem::path const input { arguments[1] };
+    std::filesystem::path const source { arguments[2] };
+    std::string_view const symbol { arguments[3] };
+    std::string_view const namespaceName { arguments.size() == 5 ? arguments[4] : "" };
+
+    auto const compiled = libpreprocessor::compile(input);
+
+    if (!compiled.has_value())
+    {
+        fmt::print(stderr, "{}\n", compiled.error().message());
+        return EXIT_FAILURE;
+    }
+
+    auto const image = libpreprocessor::save_image(compiled.value());
+
+    if (!image.has_value())
+    {
+        fmt::print(stderr, "{}\n", image.error().message());
+        return EXIT_FAILURE;
+    }
+
+    auto const code = fmt::format(
+        "// generated by libpreprocessor_embed from {}, don't edit.\n"
+        "\n"
+        "#include <string_view>\n"
+        "\n"
+        "{}"
+        "extern std::string_view const {};\n"
+        "constinit std::string_view const {} {{\n"
+        "    {},\n"
+        "    {}\n"
+        "}};\n"
+        "{}",
+        input.filename().string(),
+        namespaceName.empty() ? "" : fmt::format("namespace {} {{\n\n", namespaceName),
+        symbol, symbol, quote(image.value()), image.value().size(),
+        namespaceName.empty() ? "" : fmt::format("\n}} // namespace {}\n", namespaceName));
+
+    // an unchanged source is left alone, so it isn't compiled again for nothing.
+    if (std::ifstream existing { source, std::ios::binary }; existing)
+    {
+        std::string const contents { std::istreambuf_iterator<char> { existing }, {} };
+        if (contents == code) return EXIT_SUCCESS;
+    }
+
+    if (source.has_parent_path()) std::filesystem::create_directories(source.parent_path());
+
+    std::ofstream output { source, std::ios::binary };
+    output << code;
+
+    if (!output)
+    {
+        fmt::print(stderr, "couldn't write \"{}\".\n", source.string());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}